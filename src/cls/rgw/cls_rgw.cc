@@ -552,6 +552,15 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
   // wanting to slow down this op with too many omap reads
   constexpr int max_attempts = 8;
 
+  // when a delimiter is given and a subdirectory ran past the end of
+  // what get_obj_vals returned, the next call seeks past it and reads
+  // only a few entries rather than a full batch, so a large
+  // subdirectory costs an omap seek rather than a batch of entries
+  // that would be skipped; the read grows again while top-level
+  // entries come back. these probes are limited separately
+  constexpr int max_probes = 64;
+  constexpr uint32_t min_probe_entries = 2;
+
   auto iter = in->cbegin();
 
   rgw_cls_list_op op;
@@ -614,29 +623,43 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
     start_after_omap_key = cls_rgw_after_delim(start_after_omap_key);
   }
 
-  for (int attempt = 0;
-       attempt < max_attempts &&
+  int attempt = 0;
+  int probes = 0;
+  uint32_t probe_entries = 0; // non-zero while probing past subdirectories
+  while (attempt < max_attempts &&
+	 probes < max_probes &&
 	 more &&
 	 !done &&
-	 name_entry_map.size() < op.num_entries;
-       ++attempt) {
+	 name_entry_map.size() < op.num_entries) {
     std::map<std::string, bufferlist> keys;
 
+    uint32_t read_entries = op.num_entries - name_entry_map.size();
+    if (probe_entries > 0 && probe_entries < read_entries) {
+      read_entries = probe_entries;
+      ++probes;
+    } else {
+      ++attempt;
+    }
+
     // note: get_obj_vals skips past the "ugly namespace" (i.e.,
     // entries that start with the BI_PREFIX_CHAR), so no need to
     // check for such entries
     rc = get_obj_vals(hctx, start_after_omap_key, op.filter_prefix,
-		      op.num_entries - name_entry_map.size(),
-		      &keys, &more);
+		      read_entries, &keys, &more);
     if (rc < 0) {
       return rc;
     }
-    CLS_LOG(20, "%s: on attempt %d get_obj_vls returned %ld entries, more=%d",
-	    __func__, attempt, keys.size(), more);
+    CLS_LOG(20, "%s: on attempt %d probe %d get_obj_vls(%u) returned %ld entries, more=%d",
+	    __func__, attempt, probes, read_entries, keys.size(), more);
 
     done = keys.empty();
 
+    // whether the last key handled skipped a subdirectory past the
+    // end of keys
+    bool skipped_past_end = false;
+
     for (auto kiter = keys.cbegin(); kiter != keys.cend(); ++kiter) {
+      skipped_past_end = false;
       rgw_bucket_dir_entry entry;
       try {
 	const bufferlist& entrybl = kiter->second;
@@ -718,6 +741,7 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
 	  // advance past this subdirectory, but then back up one,
 	  // so the loop increment will put us in the right place
 	  kiter = keys.lower_bound(start_after_omap_key);
+	  skipped_past_end = (kiter == keys.cend());
 	  --kiter;
 
           continue;
@@ -736,7 +760,13 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
 		int(name_entry_map.size()));
       }
     } // for (auto kiter...
-  } // for (int attempt...
+
+    if (skipped_past_end) {
+      probe_entries = min_probe_entries;
+    } else if (probe_entries > 0 && probe_entries < op.num_entries) {
+      probe_entries *= 2;
+    }
+  } // while (attempt...
 
   ret.is_truncated = more && !done;
   if (ret.is_truncated) {
@@ -4061,6 +4091,110 @@ static int rgw_reshard_log_trim_op(cls_method_context_t hctx, bufferlist *in, bu
   return 0;
 }
 
+static int rgw_reshard_log_trim_entries_op(cls_method_context_t hctx,
+                                           bufferlist *in, bufferlist *out)
+{
+  rgw_cls_reshard_log_trim_entries_op op;
+  try {
+    auto iter = in->cbegin();
+    decode(op, iter);
+  } catch (const ceph::buffer::error&) {
+    CLS_LOG(0, "ERROR: %s: failed to decode request", __func__);
+    return -EINVAL;
+  }
+
+  const size_t limit = cls_get_config(hctx)->osd_max_omap_entries_per_request;
+  if (op.entries.size() > limit) {
+    int r = -E2BIG;
+    CLS_LOG(0, "ERROR: %s: got too many entries (%zu > %zu), returning %d",
+            __func__, op.entries.size(), limit, r);
+    return r;
+  }
+
+  rgw_bucket_dir_header header;
+  int rc = read_bucket_header(hctx, &header);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: %s: failed to read header", __func__);
+    return rc;
+  }
+
+  std::set<std::string> keys;
+  for (const auto& entry : op.entries) {
+    string key;
+    bi_reshard_log_key(hctx, key, entry.idx);
+    keys.insert(std::move(key));
+  }
+
+  std::map<std::string, ceph::buffer::list> vals;
+  rc = cls_cxx_map_get_vals_by_keys(hctx, keys, &vals);
+  if (rc < 0) {
+    CLS_LOG(0, "ERROR: %s: cls_cxx_map_get_vals_by_keys() returned r=%d",
+            __func__, rc);
+    return rc;
+  }
+
+  uint32_t removed = 0;
+  for (const auto& entry : op.entries) {
+    string key;
+    bi_reshard_log_key(hctx, key, entry.idx);
+    auto i = vals.find(key);
+    if (i == vals.end()) {
+      continue;
+    }
+    rgw_cls_bi_entry logged;
+    try {
+      auto biter = i->second.cbegin();
+      decode(logged, biter);
+    } catch (const ceph::buffer::error&) {
+      CLS_LOG(0, "ERROR: %s: failed to decode reshard log entry %s",
+              __func__, escape_str(key).c_str());
+      return -EIO;
+    }
+    if (!logged.data.contents_equal(entry.data)) {
+      // rewritten by a client op since it was listed; leave it for the
+      // next pass over the log
+      CLS_LOG(20, "%s: skipping rewritten entry %s", __func__,
+              escape_str(entry.idx).c_str());
+      continue;
+    }
+    rc = cls_cxx_map_remove_key(hctx, key);
+    if (rc < 0) {
+      CLS_LOG(1, "ERROR: %s: cls_cxx_map_remove_key(%s) returned r=%d",
+              __func__, escape_str(key).c_str(), rc);
+      return rc;
+    }
+    vals.erase(i);
+    ++removed;
+  }
+
+  if (removed == 0) {
+    return 0;
+  }
+
+  // reshardlog_entries counts logged writes rather than distinct keys, so
+  // reset it once the log is empty and otherwise clamp at zero. lowering it
+  // lets client writes proceed again if the log had grown past
+  // rgw_reshardlog_threshold
+  string key_begin;
+  bi_reshard_log_prefix(key_begin);
+  string key_end(1, BI_PREFIX_CHAR);
+  key_end.append(bucket_index_prefixes[BI_BUCKET_RESHARD_LOG_INDEX + 1]);
+
+  std::set<std::string> remaining;
+  bool more = false;
+  rc = cls_cxx_map_get_keys(hctx, key_begin, 1, &remaining, &more);
+  if (rc < 0) {
+    CLS_LOG(1, "ERROR: %s: cls_cxx_map_get_keys failed rc=%d", __func__, rc);
+    return rc;
+  }
+  if (remaining.empty() || *remaining.begin() >= key_end) {
+    header.reshardlog_entries = 0;
+  } else {
+    header.reshardlog_entries -= std::min(removed, header.reshardlog_entries);
+  }
+  return write_bucket_header(hctx, &header);
+}
+
 static void usage_record_prefix_by_time(uint64_t epoch, string& key)
 {
   char buf[32];
@@ -5320,6 +5454,7 @@ CLS_INIT(rgw)
   cls_method_handle_t h_rgw_bi_put_entries_op;
   cls_method_handle_t h_rgw_bi_list_op;
   cls_method_handle_t h_rgw_reshard_log_trim_op;
+  cls_method_handle_t h_rgw_reshard_log_trim_entries_op;
   cls_method_handle_t h_rgw_bi_log_list_op;
   cls_method_handle_t h_rgw_bi_log_trim_op;
   cls_method_handle_t h_rgw_bi_log_resync_op;
@@ -5387,6 +5522,8 @@ CLS_INIT(rgw)
   cls.register_cxx_method(bi_put_entries, rgw_bi_put_entries, &h_rgw_bi_put_entries_op);
   cls.register_cxx_method(bi_list, rgw_bi_list_op, &h_rgw_bi_list_op);
   cls.register_cxx_method(reshard_log_trim, rgw_reshard_log_trim_op, &h_rgw_reshard_log_trim_op);
+  cls.register_cxx_method(reshard_log_trim_entries, rgw_reshard_log_trim_entries_op,
+                          &h_rgw_reshard_log_trim_entries_op);
 
   cls.register_cxx_method(bi_log_list, rgw_bi_log_list, &h_rgw_bi_log_list_op);
   cls.register_cxx_method(bi_log_trim, rgw_bi_log_trim, &h_rgw_bi_log_trim_op);
@@ -149,6 +149,30 @@ void cls_rgw_bucket_list_op(librados::ObjectReadOperation& op,
 	  new ClsBucketIndexOpCtx<rgw_cls_list_ret>(result, NULL));
 }
 
+cls_rgw_obj_key cls_rgw_bucket_list_resume_key(const rgw_cls_list_ret& result,
+                                               const cls_rgw_obj_key& start_after)
+{
+  cls_rgw_obj_key key = start_after;
+  if (!result.dir.m.empty()) {
+    const auto& last = result.dir.m.rbegin()->second;
+    cls_rgw_obj_key last_key = last.key;
+    if (last.is_common_prefix()) {
+      // skip everything beneath the common prefix, as
+      // list_objects_ordered() does with its marker
+      last_key.name = cls_rgw_after_delim(last.key.name);
+      last_key.instance.clear();
+    }
+    key = std::max(key, last_key);
+  }
+  // the marker may lie past the last entry returned, or be set when no
+  // entries were returned at all, if cls skipped or filtered everything
+  // it scanned
+  if (!result.marker.empty()) {
+    key = std::max(key, result.marker);
+  }
+  return key;
+}
+
 void cls_rgw_remove_obj(librados::ObjectWriteOperation& o, list<string>& keep_attr_prefixes)
 {
   bufferlist in;
@@ -445,6 +469,18 @@ void cls_rgw_bucket_reshard_log_trim(librados::ObjectWriteOperation& op)
   op.exec(method::reshard_log_trim, in);
 }
 
+void cls_rgw_bucket_reshard_log_trim_entries(librados::ObjectWriteOperation& op,
+                                             std::vector<rgw_cls_bi_entry> entries)
+{
+  const auto call = rgw_cls_reshard_log_trim_entries_op{
+    .entries = std::move(entries)
+  };
+
+  bufferlist in;
+  encode(call, in);
+  op.exec(method::reshard_log_trim_entries, in);
+}
+
 void cls_rgw_bucket_check_index(librados::ObjectReadOperation& op,
                                 bufferlist& out)
 {
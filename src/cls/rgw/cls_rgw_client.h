@@ -205,6 +205,12 @@ void cls_rgw_bucket_list_op(librados::ObjectReadOperation& op,
                             bool list_versions,
                             rgw_cls_list_ret* result);
 
+// where a follow-up bucket_list of the same shard resumes after
+// `result`; start_after is the key the read that produced it started
+// after, and is returned when the result doesn't move past it
+cls_rgw_obj_key cls_rgw_bucket_list_resume_key(const rgw_cls_list_ret& result,
+                                               const cls_rgw_obj_key& start_after);
+
 void cls_rgw_bilog_list(librados::ObjectReadOperation& op,
                         const std::string& marker, uint32_t max,
                         cls_rgw_bi_log_list_ret *pdata, int *ret = nullptr);
@@ -308,3 +314,8 @@ void cls_rgw_get_bucket_resharding_decode(const bufferlist& out,
 // Try to remove all reshard log entries from the bucket index. Return success
 // if any entries were removed, and -ENODATA once they're all gone.
 void cls_rgw_bucket_reshard_log_trim(librados::ObjectWriteOperation& op);
+
+// Remove the given reshard log entries, as returned by a reshardlog listing,
+// unless they've been rewritten since they were listed.
+void cls_rgw_bucket_reshard_log_trim_entries(librados::ObjectWriteOperation& op,
+                                             std::vector<rgw_cls_bi_entry> entries);
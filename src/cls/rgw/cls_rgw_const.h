@@ -38,6 +38,7 @@ constexpr int RGWBIAdvanceAndRetryError = -EFBIG;
 #define RGW_BI_LIST "bi_list"
 
 #define RGW_RESHARD_LOG_TRIM "reshard_log_trim"
+#define RGW_RESHARD_LOG_TRIM_ENTRIES "reshard_log_trim_entries"
 
 #define RGW_BI_LOG_LIST "bi_log_list"
 #define RGW_BI_LOG_TRIM "bi_log_trim"
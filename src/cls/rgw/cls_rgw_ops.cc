@@ -629,3 +629,8 @@ void rgw_cls_bi_put_entries_op::dump(Formatter *f) const
   encode_json("entries", entries, f);
   encode_json("check_existing", check_existing, f);
 }
+
+void rgw_cls_reshard_log_trim_entries_op::dump(Formatter *f) const
+{
+  encode_json("entries", entries, f);
+}
@@ -815,6 +815,35 @@ struct rgw_cls_bi_put_entries_op {
 };
 WRITE_CLASS_ENCODER(rgw_cls_bi_put_entries_op)
 
+struct rgw_cls_reshard_log_trim_entries_op {
+  // entries as returned by a reshardlog listing; each one is only removed
+  // if its log record hasn't been rewritten since
+  std::vector<rgw_cls_bi_entry> entries;
+
+  void encode(ceph::buffer::list& bl) const {
+    ENCODE_START(1, 1, bl);
+    encode(entries, bl);
+    ENCODE_FINISH(bl);
+  }
+
+  void decode(ceph::buffer::list::const_iterator& bl) {
+    DECODE_START(1, bl);
+    decode(entries, bl);
+    DECODE_FINISH(bl);
+  }
+
+  void dump(ceph::Formatter *f) const;
+
+  static std::list<rgw_cls_reshard_log_trim_entries_op> generate_test_instances() {
+    std::list<rgw_cls_reshard_log_trim_entries_op> o;
+    o.emplace_back();
+    o.emplace_back();
+    o.back().entries.push_back({.idx = "entry"});
+    return o;
+  }
+};
+WRITE_CLASS_ENCODER(rgw_cls_reshard_log_trim_entries_op)
+
 struct rgw_cls_bi_list_op {
   uint32_t max;
   std::string name_filter; // limit result to one object and its instances
@@ -1828,6 +1857,7 @@ constexpr auto bi_put = ClsMethod<RdWrTag, ClassId>(RGW_BI_PUT);
 constexpr auto bi_put_entries = ClsMethod<RdWrTag, ClassId>(RGW_BI_PUT_ENTRIES);
 constexpr auto bi_list = ClsMethod<RdTag, ClassId>(RGW_BI_LIST);
 constexpr auto reshard_log_trim = ClsMethod<RdWrTag, ClassId>(RGW_RESHARD_LOG_TRIM);
+constexpr auto reshard_log_trim_entries = ClsMethod<RdWrTag, ClassId>(RGW_RESHARD_LOG_TRIM_ENTRIES);
 constexpr auto bi_log_list = ClsMethod<RdTag, ClassId>(RGW_BI_LOG_LIST);
 constexpr auto bi_log_trim = ClsMethod<RdWrTag, ClassId>(RGW_BI_LOG_TRIM);
 constexpr auto dir_suggest_changes = ClsMethod<RdWrTag, ClassId>(RGW_DIR_SUGGEST_CHANGES);
@@ -86,6 +86,47 @@ static ceph::spinlock debug_lock;
     return buffer_missed_crc;
   }
 
+  /*
+   * ptr_node pool.  every ptr that lands in a list without being
+   * hypercombined needs its own ptr_node; encode-heavy paths push many
+   * of those, so keep a bounded per-thread free list instead of going
+   * back to the allocator for each one.  a node freed on another thread
+   * simply joins that thread's list.
+   */
+  static bool buffer_ptr_node_pool =
+    !get_env_bool("CEPH_BUFFER_NO_PTR_NODE_POOL");
+  static constexpr unsigned PTR_NODE_POOL_MAX = 256;
+
+  namespace {
+  struct ptr_node_pool_t {
+    void* head = nullptr;
+    unsigned count = 0;
+    uint64_t hits = 0;
+    bool exited = false;
+  };
+  // trivially destructible so it stays usable while other thread_local
+  // destructors release their lists.
+  thread_local ptr_node_pool_t ptr_node_pool;
+
+  struct ptr_node_pool_reaper_t {
+    ~ptr_node_pool_reaper_t() {
+      auto& pool = ptr_node_pool;
+      pool.exited = true;
+      while (pool.head) {
+	void* p = pool.head;
+	pool.head = *static_cast<void**>(p);
+	::operator delete(p);
+      }
+      pool.count = 0;
+    }
+  };
+  thread_local ptr_node_pool_reaper_t ptr_node_pool_reaper;
+  }
+
+  uint64_t buffer::get_ptr_node_pool_hits() {
+    return ptr_node_pool.hits;
+  }
+
   /*
    * raw_combined is always placed within a single allocation along
    * with the data buffer.  the data goes at the beginning, and
@@ -2287,6 +2328,36 @@ buffer::ptr_node::create_hypercombined(ceph::unique_leakable_ptr<buffer::raw> r)
     new ptr_node(std::move(r)));
 }
 
+void* buffer::ptr_node::operator new(const std::size_t size)
+{
+  static_assert(sizeof(ptr_node) >= sizeof(void*));
+  auto& pool = ptr_node_pool;
+  if (pool.head && size == sizeof(ptr_node)) {
+    void* p = pool.head;
+    pool.head = *static_cast<void**>(p);
+    --pool.count;
+    ++pool.hits;
+    return p;
+  }
+  return ::operator new(size);
+}
+
+void buffer::ptr_node::operator delete(void* const p,
+				       const std::size_t size) noexcept
+{
+  auto& pool = ptr_node_pool;
+  if (buffer_ptr_node_pool && size == sizeof(ptr_node) &&
+      pool.count < PTR_NODE_POOL_MAX && !pool.exited) {
+    // make sure the reaper runs at thread exit
+    (void)&ptr_node_pool_reaper;
+    *static_cast<void**>(p) = pool.head;
+    pool.head = p;
+    ++pool.count;
+    return;
+  }
+  ::operator delete(p);
+}
+
 buffer::ptr_node* buffer::ptr_node::cloner::operator()(
   const buffer::ptr_node& clone_this)
 {
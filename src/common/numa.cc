@@ -159,7 +159,6 @@ static int easy_readdir(const std::string& dir, std::set<std::string> *out)
   return 0;
 }
 
-#ifdef HAVE_DPDK
 static std::string get_task_comm(pid_t tid)
 {
   static const char* comm_fmt = "/proc/self/task/%d/comm";
@@ -185,7 +184,6 @@ static std::string get_task_comm(pid_t tid)
   }
   return name;
 }
-#endif
 
 int set_cpu_affinity_all_threads(size_t cpu_set_size, cpu_set_t *cpu_set)
 {
@@ -227,6 +225,45 @@ int set_cpu_affinity_all_threads(size_t cpu_set_size, cpu_set_t *cpu_set)
   return 0;
 }
 
+int set_cpu_affinity_named_threads(const std::vector<std::string>& prefixes,
+				   size_t cpu_set_size,
+				   cpu_set_t *cpu_set)
+{
+  std::set<std::string> ls;
+  std::string path = "/proc/"s + stringify(getpid()) + "/task";
+  int r = easy_readdir(path, &ls);
+  if (r < 0) {
+    return r;
+  }
+  int matched = 0;
+  for (auto& i : ls) {
+    pid_t tid = atoll(i.c_str());
+    if (!tid) {
+      continue;
+    }
+    std::string thread_name = get_task_comm(tid);
+    bool match = false;
+    for (auto& prefix : prefixes) {
+      if (!thread_name.compare(0, prefix.size(), prefix)) {
+	match = true;
+	break;
+      }
+    }
+    if (!match) {
+      continue;
+    }
+    r = sched_setaffinity(tid, cpu_set_size, cpu_set);
+    if (r < 0) {
+      if (errno == ESRCH) {
+	continue;  // thread exited
+      }
+      return -errno;
+    }
+    ++matched;
+  }
+  return matched;
+}
+
 #else
 int parse_cpu_set_list(const char *s,
 		       size_t *cpu_set_size,
@@ -260,4 +297,11 @@ int set_cpu_affinity_all_threads(size_t cpu_set_size,
   return -ENOTSUP;
 }
 
+int set_cpu_affinity_named_threads(const std::vector<std::string>& prefixes,
+				   size_t cpu_set_size,
+				   cpu_set_t *cpu_set)
+{
+  return -ENOTSUP;
+}
+
 #endif
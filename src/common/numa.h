@@ -11,6 +11,7 @@
 #include <cstddef> // for size_t
 #include <set>
 #include <string>
+#include <vector>
 
 int parse_cpu_set_list(const char *s,
 		       size_t *cpu_set_size,
@@ -26,3 +27,9 @@ int get_numa_node_cpu_set(int node,
 
 int set_cpu_affinity_all_threads(size_t cpu_set_size,
 				 cpu_set_t *cpu_set);
+
+// set the affinity of every thread whose name starts with one of the
+// given prefixes; returns the number of threads updated or -errno
+int set_cpu_affinity_named_threads(const std::vector<std::string>& prefixes,
+				   size_t cpu_set_size,
+				   cpu_set_t *cpu_set);
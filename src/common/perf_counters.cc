@@ -21,6 +21,8 @@
 #include "include/common_fwd.h"
 #include "include/utime.h"
 
+#include <algorithm>
+#include <bit>
 #include <sstream>
 
 using std::ostringstream;
@@ -167,6 +169,48 @@ void PerfCountersCollectionImpl::with_counters(std::function<void(
 
 // ---------------------------
 
+// threads are spread over the shards round-robin, in creation order
+static unsigned perf_counter_shard_index()
+{
+  static std::atomic<unsigned> next_index = 0;
+  static thread_local unsigned index = next_index++;
+  return index;
+}
+
+void PerfCounters::perf_counter_data_any_d::add(uint64_t v)
+{
+  auto *sum = &u64, *count = &avgcount, *count2 = &avgcount2;
+  if (shards) {
+    auto& shard = shards[perf_counter_shard_index() & shard_mask];
+    sum = &shard.u64;
+    count = &shard.avgcount;
+    count2 = &shard.avgcount2;
+  }
+  if (type & PERFCOUNTER_LONGRUNAVG) {
+    (*count)++;
+    *sum += v;
+    (*count2)++;
+  } else {
+    *sum += v;
+  }
+}
+
+void PerfCounters::perf_counter_data_any_d::set(uint64_t v)
+{
+  if (shards) {
+    for (unsigned i = 0; i <= shard_mask; ++i) {
+      shards[i].reset();
+    }
+  }
+  if (type & PERFCOUNTER_LONGRUNAVG) {
+    avgcount++;
+    u64 = v;
+    avgcount2++;
+  } else {
+    u64 = v;
+  }
+}
+
 PerfCounters::~PerfCounters()
 {
 }
@@ -183,13 +227,7 @@ void PerfCounters::inc(int idx, uint64_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt;
-    data.avgcount2++;
-  } else {
-    data.u64 += amt;
-  }
+  data.add(amt);
 }
 
 void PerfCounters::inc_with_max(int idx, uint64_t amt)
@@ -204,16 +242,12 @@ void PerfCounters::inc_with_max(int idx, uint64_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return;
+  data.add(amt);
   if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt;
     uint64_t m;
     do {
       m = data.max_u64_inc.load();
     } while(amt > m && !data.max_u64_inc.compare_exchange_weak(m, amt));
-    data.avgcount2++;
-  } else {
-    data.u64 += amt;
   }
 }
 
@@ -230,7 +264,7 @@ void PerfCounters::dec(int idx, uint64_t amt)
   ceph_assert(!(data.type & PERFCOUNTER_LONGRUNAVG));
   if (!(data.type & PERFCOUNTER_U64))
     return;
-  data.u64 -= amt;
+  data.add(-amt);
 }
 
 void PerfCounters::set(int idx, uint64_t amt)
@@ -248,13 +282,7 @@ void PerfCounters::set(int idx, uint64_t amt)
 
   ANNOTATE_BENIGN_RACE_SIZED(&data.u64, sizeof(data.u64),
                              "perf counter atomic");
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 = amt;
-    data.avgcount2++;
-  } else {
-    data.u64 = amt;
-  }
+  data.set(amt);
 }
 
 uint64_t PerfCounters::get(int idx) const
@@ -269,7 +297,7 @@ uint64_t PerfCounters::get(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_U64))
     return 0;
-  return data.u64;
+  return data.read_u64();
 }
 
 void PerfCounters::tinc(int idx, utime_t amt)
@@ -284,13 +312,7 @@ void PerfCounters::tinc(int idx, utime_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.to_nsec();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.to_nsec();
-  }
+  data.add(amt.to_nsec());
 }
 
 void PerfCounters::tinc_with_max(int idx, utime_t amt)
@@ -305,17 +327,13 @@ void PerfCounters::tinc_with_max(int idx, utime_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
+  uint64_t new_m = amt.to_nsec();
+  data.add(new_m);
   if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    uint64_t new_m = amt.to_nsec();
-    data.avgcount++;
-    data.u64 += new_m;
     uint64_t m;
     do {
       m = data.max_u64_inc.load();
     } while(new_m > m && !data.max_u64_inc.compare_exchange_weak(m, new_m));
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.to_nsec();
   }
 }
 
@@ -331,13 +349,7 @@ void PerfCounters::tinc(int idx, ceph::timespan amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    data.avgcount++;
-    data.u64 += amt.count();
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.count();
-  }
+  data.add(amt.count());
 }
 
 void PerfCounters::tinc_with_max(int idx, ceph::timespan amt)
@@ -352,17 +364,13 @@ void PerfCounters::tinc_with_max(int idx, ceph::timespan amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
+  uint64_t new_m = amt.count();
+  data.add(new_m);
   if (data.type & PERFCOUNTER_LONGRUNAVG) {
-    uint64_t new_m = amt.count();
-    data.avgcount++;
-    data.u64 += new_m;
     uint64_t m;
     do {
       m = data.max_u64_inc.load();
     } while(new_m > m && !data.max_u64_inc.compare_exchange_weak(m, new_m));
-    data.avgcount2++;
-  } else {
-    data.u64 += amt.count();
   }
 }
 
@@ -378,9 +386,9 @@ void PerfCounters::tset(int idx, utime_t amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  data.u64 = amt.to_nsec();
   if (data.type & PERFCOUNTER_LONGRUNAVG)
     ceph_abort();
+  data.set(amt.to_nsec());
 }
 
 void PerfCounters::tset(int idx, ceph::timespan amt)
@@ -395,9 +403,9 @@ void PerfCounters::tset(int idx, ceph::timespan amt)
   perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return;
-  data.u64 = amt.count();
   if (data.type & PERFCOUNTER_LONGRUNAVG)
     ceph_abort();
+  data.set(amt.count());
 }
 
 utime_t PerfCounters::tget(int idx) const
@@ -412,7 +420,7 @@ utime_t PerfCounters::tget(int idx) const
   const perf_counter_data_any_d& data(m_data[idx - m_lower_bound - 1]);
   if (!(data.type & PERFCOUNTER_TIME))
     return utime_t();
-  uint64_t v = data.u64;
+  uint64_t v = data.read_u64();
   return utime_t(v / 1000000000ull, v % 1000000000ull);
 }
 
@@ -430,7 +438,11 @@ void PerfCounters::hinc(int idx, int64_t x, int64_t y)
   ceph_assert(data.type == (PERFCOUNTER_HISTOGRAM | PERFCOUNTER_COUNTER | PERFCOUNTER_U64));
   ceph_assert(data.histogram);
 
-  data.histogram->inc(x, y);
+  if (!data.histogram_shards.empty()) {
+    data.histogram_shards[perf_counter_shard_index() & data.shard_mask]->inc(x, y);
+  } else {
+    data.histogram->inc(x, y);
+  }
 }
 
 pair<uint64_t, uint64_t> PerfCounters::get_tavg_ns(int idx) const
@@ -600,9 +612,17 @@ void PerfCounters::dump_formatted_generic(Formatter *f, bool schema,
         ceph_assert(d->type == (PERFCOUNTER_HISTOGRAM | PERFCOUNTER_COUNTER | PERFCOUNTER_U64));
         ceph_assert(d->histogram);
         Formatter::ObjectSection histogram_section{*f, d->name};
-        d->histogram->dump_formatted(f);
+        if (!d->histogram_shards.empty()) {
+          PerfHistogram<> h(*d->histogram);
+          for (auto& shard : d->histogram_shards) {
+            h.add(*shard);
+          }
+          h.dump_formatted(f);
+        } else {
+          d->histogram->dump_formatted(f);
+        }
       } else {
-	uint64_t v = d->u64;
+	uint64_t v = d->read_u64();
 	if (d->type & PERFCOUNTER_U64) {
 	  f->dump_unsigned(d->name, v);
 	} else if (d->type & PERFCOUNTER_TIME) {
@@ -641,6 +661,11 @@ PerfCountersBuilder::PerfCountersBuilder(CephContext *cct, const std::string &na
                   int first, int last)
   : m_perf_counters(new PerfCounters(cct, name, first, last))
 {
+#ifndef WITH_CRIMSON
+  if (auto n = cct->_conf.get_val<uint64_t>("perf_counters_shards"); n > 1) {
+    num_shards = std::bit_ceil(std::min<uint64_t>(n, 256));
+  }
+#endif
 }
 
 PerfCountersBuilder::~PerfCountersBuilder()
@@ -721,6 +746,18 @@ void PerfCountersBuilder::add_impl(
   data.type = (enum perfcounter_type_d)ty;
   data.unit = (enum unit_t) unit;
   data.histogram = std::move(histogram);
+  if (sharded && num_shards > 1 &&
+      (ty & (PERFCOUNTER_COUNTER | PERFCOUNTER_LONGRUNAVG))) {
+    data.shard_mask = num_shards - 1;
+    if (data.histogram) {
+      for (unsigned i = 0; i < num_shards; ++i) {
+	data.histogram_shards.emplace_back(
+	  std::make_unique<PerfHistogram<>>(*data.histogram));
+      }
+    } else {
+      data.shards.reset(new PerfCounters::perf_counter_shard_d[num_shards]);
+    }
+  }
 }
 
 PerfCounters *PerfCountersBuilder::create_perf_counters()
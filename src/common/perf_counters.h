@@ -125,6 +125,14 @@ public:
     prio_default = prio_;
   }
 
+  // counters (but not gauges) added while this is set are backed by
+  // per-thread slots, summed only when read, if perf_counters_shards > 1.
+  // Use it for hot counters updated from many threads.
+  void set_sharded(bool sharded_)
+  {
+    sharded = sharded_;
+  }
+
   PerfCounters* create_perf_counters();
 private:
   PerfCountersBuilder(const PerfCountersBuilder &rhs);
@@ -136,6 +144,8 @@ private:
   PerfCounters *m_perf_counters;
 
   int prio_default = 0;
+  bool sharded = false;
+  unsigned num_shards = 0;
 };
 
 /*
@@ -166,6 +176,28 @@ private:
 class PerfCounters
 {
 public:
+  /** A per-thread slot of a sharded counter, on its own cache line. */
+  struct alignas(64) perf_counter_shard_d {
+    std::atomic<uint64_t> u64 = { 0 };
+    std::atomic<uint64_t> avgcount = { 0 };
+    std::atomic<uint64_t> avgcount2 = { 0 };
+
+    void reset() {
+      u64 = 0;
+      avgcount = 0;
+      avgcount2 = 0;
+    }
+
+    std::pair<uint64_t,uint64_t> read_avg() const {
+      uint64_t sum, count;
+      do {
+	count = avgcount2;
+	sum = u64;
+      } while (avgcount != count);
+      return { sum, count };
+    }
+  };
+
   /** Represents a PerfCounters data element. */
   struct perf_counter_data_any_d {
     perf_counter_data_any_d()
@@ -201,6 +233,12 @@ public:
     std::atomic<uint64_t> avgcount2 = { 0 };
     std::unique_ptr<PerfHistogram<>> histogram;
 
+    // set for sharded counters; the values above then only hold what was
+    // set() explicitly, and readers add up the shards
+    std::unique_ptr<perf_counter_shard_d[]> shards;
+    std::vector<std::unique_ptr<PerfHistogram<>>> histogram_shards;
+    unsigned shard_mask = 0;
+
     void reset()
     {
       if (type != PERFCOUNTER_U64) {
@@ -208,10 +246,36 @@ public:
 	    max_u64_inc = 0;
 	    avgcount = 0;
 	    avgcount2 = 0;
+	    if (shards) {
+	      for (unsigned i = 0; i <= shard_mask; ++i) {
+		shards[i].reset();
+	      }
+	    }
       }
       if (histogram) {
         histogram->reset();
       }
+      for (auto& h : histogram_shards) {
+        h->reset();
+      }
+    }
+
+    /// add v to the value (and bump the count of averages), either
+    /// directly or through the calling thread's shard
+    void add(uint64_t v);
+
+    /// set the value, dropping anything accumulated in the shards
+    void set(uint64_t v);
+
+    /// the value of a non-average counter
+    uint64_t read_u64() const {
+      uint64_t v = u64;
+      if (shards) {
+	for (unsigned i = 0; i <= shard_mask; ++i) {
+	  v += shards[i].u64;
+	}
+      }
+      return v;
     }
 
     // read <sum, count> safely by making sure the post- and pre-count
@@ -223,6 +287,7 @@ public:
 	count = avgcount2;
 	sum = u64;
       } while (avgcount != count);
+      add_shards(sum, count);
       return { sum, count };
     }
     std::tuple<uint64_t,uint64_t, uint64_t> read_avg_ex() const {
@@ -232,8 +297,22 @@ public:
 	_sum = u64;
 	_max = max_u64_inc;
       } while (avgcount != _count);
+      add_shards(_sum, _count);
       return { _sum, _count, _max };
     }
+
+  private:
+    // each shard is consistent on its own; the total may be off by the
+    // updates racing with the read, just like two unsharded reads would
+    void add_shards(uint64_t& sum, uint64_t& count) const {
+      if (shards) {
+	for (unsigned i = 0; i <= shard_mask; ++i) {
+	  auto [s, c] = shards[i].read_avg();
+	  sum += s;
+	  count += c;
+	}
+      }
+    }
   };
 
   template <typename T>
@@ -123,6 +123,15 @@ public:
     m_rawData[index]++;
   }
 
+  /// Add the counters of another histogram with the same axes
+  void add(const PerfHistogram &other) {
+    ceph_assert(get_raw_size() == other.get_raw_size());
+    auto size = get_raw_size();
+    for (auto i = size; --i >= 0;) {
+      m_rawData[i] += other.m_rawData[i];
+    }
+  }
+
   /// Read value from given bucket
   template <typename... T>
   uint64_t read_bucket(T... bucket) const {
@@ -159,7 +168,7 @@ protected:
   }
 
   /// Get number of all histogram counters
-  int64_t get_raw_size() {
+  int64_t get_raw_size() const {
     int64_t ret = 1;
     for (const auto &ac : m_axes_config) {
       ret *= ac.m_buckets;
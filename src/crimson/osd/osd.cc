@@ -976,6 +976,8 @@ OSD::do_ms_dispatch(
     return handle_osd_map(boost::static_pointer_cast<MOSDMap>(m));
   case CEPH_MSG_OSD_OP:
     return handle_osd_op(conn, boost::static_pointer_cast<MOSDOp>(m));
+  case MSG_OSD_OP_BATCH:
+    return handle_osd_op_batch(conn, boost::static_pointer_cast<MOSDOpBatch>(m));
   case MSG_OSD_PG_CREATE2:
     return handle_pg_create(
       conn, boost::static_pointer_cast<MOSDPGCreate2>(m));
@@ -1384,6 +1386,17 @@ seastar::future<> OSD::handle_osd_op(
     std::move(m)).second;
 }
 
+seastar::future<> OSD::handle_osd_op_batch(
+  crimson::net::ConnectionRef conn,
+  Ref<MOSDOpBatch> m)
+{
+  // every op is handled on its own, in the order of the batch
+  return seastar::do_for_each(m->ops, [this, conn, m](auto& op) {
+    op->set_src(m->get_source());
+    return handle_osd_op(conn, boost::static_pointer_cast<MOSDOp>(op));
+  });
+}
+
 seastar::future<> OSD::handle_pg_create(
   crimson::net::ConnectionRef conn,
   Ref<MOSDPGCreate2> m)
@@ -27,6 +27,7 @@
 #include "crimson/osd/state.h"
 
 #include "messages/MOSDOp.h"
+#include "messages/MOSDOpBatch.h"
 #include "osd/PeeringState.h"
 #include "osd/osd_types.h"
 #include "osd/osd_perf_counters.h"
@@ -209,6 +210,8 @@ private:
                                      Ref<MOSDPGCreate2> m);
   seastar::future<> handle_osd_op(crimson::net::ConnectionRef conn,
                                   Ref<MOSDOp> m);
+  seastar::future<> handle_osd_op_batch(crimson::net::ConnectionRef conn,
+                                        Ref<MOSDOpBatch> m);
   seastar::future<> handle_rep_op(crimson::net::ConnectionRef conn,
                                   Ref<MOSDRepOp> m);
   seastar::future<> handle_rep_op_reply(crimson::net::ConnectionRef conn,
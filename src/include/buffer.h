@@ -118,6 +118,8 @@ struct error_code;
   int get_missed_crc();
   /// enable/disable tracking of cached crcs
   void track_cached_crc(bool b);
+  /// count of ptr_node allocations served from this thread's pool
+  uint64_t get_ptr_node_pool_hits();
 
   /*
    * an abstract raw buffer.  with a reference count.
@@ -394,6 +396,11 @@ struct error_code;
   private:
     friend list;
 
+    // standalone (not hypercombined) nodes are recycled through a small
+    // per-thread free list; see common/buffer.cc.
+    static void* operator new(std::size_t size);
+    static void operator delete(void* p, std::size_t size) noexcept;
+
     template <class... Args>
     ptr_node(Args&&... args) : ptr(std::forward<Args>(args)...) {
     }
@@ -40,6 +40,24 @@ namespace logging {
 
 static OnExitManager exit_callbacks;
 
+static std::atomic<uint64_t> last_log_id = 0;
+
+// the Log whose thread ring locks this thread is holding or waiting for,
+// see is_inside_log_lock()
+static thread_local const Log* t_ring_lock_log = nullptr;
+
+namespace {
+struct RingLockMarker {
+  const Log* const prev;
+  explicit RingLockMarker(const Log* log) : prev(t_ring_lock_log) {
+    t_ring_lock_log = log;
+  }
+  ~RingLockMarker() {
+    t_ring_lock_log = prev;
+  }
+};
+}
+
 static void log_on_exit(void *p)
 {
   Log *l = *(Log **)p;
@@ -50,6 +68,7 @@ static void log_on_exit(void *p)
 
 Log::Log(const SubsystemMap *s)
   : m_indirect_this(nullptr),
+    m_id(++last_log_id),
     m_subs(s),
     m_recent(DEFAULT_MAX_RECENT)
 {
@@ -139,6 +158,12 @@ void Log::set_max_recent(std::size_t n)
   m_recent.set_capacity(n);
 }
 
+void Log::set_max_recent_per_thread(std::size_t n)
+{
+  // rings are resized lazily by their owning thread
+  m_max_recent_per_thread = n;
+}
+
 void Log::set_log_file(std::string_view fn)
 {
   std::scoped_lock lock(m_flush_mutex);
@@ -248,8 +273,84 @@ void Log::stop_journald_logger()
   m_journald.reset();
 }
 
+std::shared_ptr<Log::ThreadRing> Log::_get_thread_ring()
+{
+  // keyed by log id: a thread may log to more than one Log instance. the
+  // rings belong to their Log, a thread only keeps weak references to them
+  struct RingRef {
+    std::weak_ptr<ThreadRing> ring;
+    ~RingRef() {
+      // thread exit: let another thread adopt the ring
+      if (auto r = ring.lock()) {
+	r->owned = false;
+      }
+    }
+  };
+  static thread_local std::map<uint64_t, RingRef> rings;
+  if (auto i = rings.find(m_id); i != rings.end()) {
+    if (auto ring = i->second.ring.lock()) {
+      return ring;
+    }
+  }
+  // forget the rings of destroyed Log instances
+  std::erase_if(rings, [](const auto& r) { return r.second.ring.expired(); });
+
+  std::shared_ptr<ThreadRing> ring;
+  {
+    RingLockMarker marker(this);
+    std::scoped_lock lock(m_thread_rings_mutex);
+    // adopt the ring of an exited thread, so that the set of rings stays
+    // bounded by the number of live threads and old entries are kept
+    for (auto& r : m_thread_rings) {
+      if (!r->owned) {
+	r->owned = true;
+	ring = r;
+	break;
+      }
+    }
+    if (!ring) {
+      ring = m_thread_rings.emplace_back(std::make_shared<ThreadRing>());
+    }
+  }
+  rings[m_id].ring = ring;
+  return ring;
+}
+
+void Log::_collect_thread_rings(EntryVector& t)
+{
+  RingLockMarker marker(this);
+  std::scoped_lock lock(m_thread_rings_mutex);
+  for (auto& r : m_thread_rings) {
+    std::scoped_lock rlock(r->lock);
+    t.insert(t.end(),
+	     std::make_move_iterator(r->entries.begin()),
+	     std::make_move_iterator(r->entries.end()));
+    r->entries.clear();
+  }
+}
+
 void Log::submit_entry(Entry&& e)
 {
+  if (auto max = m_max_recent_per_thread.load(std::memory_order_relaxed);
+      max > 0 && m_subs->get_log_level(e.m_subsys) < e.m_prio) {
+    // gathered but never written unless we dump: stash it in this
+    // thread's ring instead of going through the shared queue
+    auto ring = _get_thread_ring();
+    RingLockMarker marker(this);
+    std::scoped_lock lock(ring->lock);
+    if (ring->entries.capacity() != max) {
+      ring->entries.set_capacity(max);
+    }
+    if (ring->entries.full()) {
+      // overwrite the oldest entry in place, reusing its buffer
+      ring->entries.front() = std::move(e);
+      ring->entries.rotate(ring->entries.begin() + 1);
+    } else {
+      ring->entries.push_back(std::move(e));
+    }
+    return;
+  }
+
   std::unique_lock lock(m_queue_mutex);
   m_queue_mutex_holder = pthread_self();
 
@@ -518,6 +619,13 @@ void Log::dump_recent()
     EntryVector t;
     t.insert(t.end(), std::make_move_iterator(m_recent.begin()), std::make_move_iterator(m_recent.end()));
     m_recent.clear();
+    if (m_max_recent_per_thread > 0) {
+      _collect_thread_rings(t);
+      std::stable_sort(t.begin(), t.end(),
+		       [](const ConcreteEntry& a, const ConcreteEntry& b) {
+			 return a.m_stamp < b.m_stamp;
+		       });
+    }
     _flush(t, true);
   }
 
@@ -544,6 +652,10 @@ void Log::dump_recent()
   }
 
   _log_message(fmt::format("  max_recent {:9}", m_recent.capacity()), true);
+  if (m_max_recent_per_thread > 0) {
+    _log_message(fmt::format("  max_recent_per_thread {:9}",
+			     m_max_recent_per_thread.load()), true);
+  }
   _log_message(fmt::format("  max_new    {:9}", m_max_new), true);
   _log_message(fmt::format("  log_file {}", m_log_file), true);
 
@@ -605,7 +717,8 @@ bool Log::is_inside_log_lock()
 {
   return
     pthread_self() == m_queue_mutex_holder ||
-    pthread_self() == m_flush_mutex_holder;
+    pthread_self() == m_flush_mutex_holder ||
+    t_ring_lock_log == this;
 }
 
 void Log::inject_segv()
@@ -6,6 +6,7 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <atomic>
 #include <condition_variable>
 #include <map>
 #include <memory>
@@ -44,6 +45,7 @@ public:
   void set_coarse_timestamps(bool coarse);
   void set_max_new(std::size_t n);
   void set_max_recent(std::size_t n);
+  void set_max_recent_per_thread(std::size_t n);
   void set_log_file(std::string_view fn);
   void reopen_log_file();
   void chown_log_file(uid_t uid, gid_t gid);
@@ -93,12 +95,21 @@ private:
 
   using RecentThreadNames = std::map<pthread_t, std::pair<mono_time, boost::circular_buffer<std::string> > >;
 
+  /// gather-only entries of one thread, kept off the shared queue
+  struct ThreadRing {
+    std::mutex lock; ///< only contended while dump_recent() collects
+    EntryRing entries;
+    std::atomic<bool> owned = true; ///< cleared when the owning thread exits
+  };
+
   static const std::size_t DEFAULT_MAX_NEW = 100;
   static const std::size_t DEFAULT_MAX_RECENT = 10000;
   static constexpr std::size_t DEFAULT_MAX_THREAD_NAMES = 4;
 
   Log **m_indirect_this;
 
+  const uint64_t m_id; ///< tells Log instances apart in thread-local caches
+
   const SubsystemMap *m_subs;
 
   std::mutex m_queue_mutex;
@@ -140,10 +151,17 @@ private:
 
   std::size_t m_max_new = DEFAULT_MAX_NEW;
 
+  std::atomic<std::size_t> m_max_recent_per_thread = 0;
+  std::mutex m_thread_rings_mutex;
+  std::vector<std::shared_ptr<ThreadRing>> m_thread_rings;
+
   bool m_inject_segv = false;
 
   void *entry() override;
 
+  std::shared_ptr<ThreadRing> _get_thread_ring();
+  void _collect_thread_rings(EntryVector& t);
+
   void _log_safe_write(std::string_view sv);
   void _flush_logbuf();
   void _log_message(std::string_view s, bool crash);
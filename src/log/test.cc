@@ -14,6 +14,10 @@
 
 #include <limits.h>
 
+#include <fstream>
+#include <iterator>
+#include <thread>
+
 using namespace std;
 using namespace ceph::logging;
 
@@ -357,6 +361,94 @@ TEST(Log, LargeFromSmallLog)
   log.stop();
 }
 
+TEST(Log, ThreadRingDump)
+{
+  static const char* test_file = "log_thread_ring";
+
+  SubsystemMap subs;
+  subs.set_log_level(1, 1);
+  subs.set_gather_level(1, 20);
+  Log log(&subs);
+  log.set_max_recent_per_thread(100);
+  log.start();
+  unlink(test_file);
+  log.set_log_file(test_file);
+  log.reopen_log_file();
+
+  auto submit = [&log](int prio, std::string_view msg) {
+    MutableEntry e(prio, 1);
+    e.get_ostream() << msg;
+    log.submit_entry(std::move(e));
+  };
+  auto read_log = [] {
+    std::ifstream f(test_file);
+    return std::string(std::istreambuf_iterator<char>(f), {});
+  };
+
+  submit(1, "logged");
+  std::thread t([&submit] { submit(10, "ring-entry-a"); });
+  t.join();
+  submit(10, "ring-entry-b");
+  log.flush();
+
+  // gather-only entries stay in memory...
+  std::string before = read_log();
+  EXPECT_NE(before.find("logged"), std::string::npos);
+  EXPECT_EQ(before.find("ring-entry"), std::string::npos);
+
+  // ...until the log is dumped, in timestamp order, including those of
+  // threads that have exited since
+  log.dump_recent();
+  std::string after = read_log();
+  auto a = after.find("ring-entry-a");
+  auto b = after.find("ring-entry-b");
+  ASSERT_NE(a, std::string::npos);
+  ASSERT_NE(b, std::string::npos);
+  EXPECT_LT(after.find("--- begin dump of recent events ---"), a);
+  EXPECT_LT(a, b);
+
+  log.stop();
+}
+
+TEST(Log, ThreadRingWrap)
+{
+  static const char* test_file = "log_thread_ring_wrap";
+
+  SubsystemMap subs;
+  subs.set_log_level(1, 1);
+  subs.set_gather_level(1, 20);
+  Log log(&subs);
+  log.set_max_recent_per_thread(3);
+  log.start();
+  unlink(test_file);
+  log.set_log_file(test_file);
+  log.reopen_log_file();
+
+  for (int i = 0; i < 5; i++) {
+    MutableEntry e(10, 1);
+    e.get_ostream() << "ring-entry-" << i;
+    log.submit_entry(std::move(e));
+  }
+  log.dump_recent();
+
+  std::ifstream f(test_file);
+  std::string out(std::istreambuf_iterator<char>(f), {});
+  // only the newest entries survive, oldest first
+  EXPECT_EQ(out.find("ring-entry-0"), std::string::npos);
+  EXPECT_EQ(out.find("ring-entry-1"), std::string::npos);
+  auto e2 = out.find("ring-entry-2");
+  auto e3 = out.find("ring-entry-3");
+  auto e4 = out.find("ring-entry-4");
+  ASSERT_NE(e2, std::string::npos);
+  ASSERT_NE(e3, std::string::npos);
+  ASSERT_NE(e4, std::string::npos);
+  EXPECT_LT(e2, e3);
+  EXPECT_LT(e3, e4);
+  EXPECT_FALSE(log.is_inside_log_lock());
+
+  log.stop();
+}
+
 // Make sure nothing bad happens when we switch
 
 TEST(Log, TimeSwitch)
@@ -0,0 +1,75 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+
+#ifndef CEPH_MOSDOPBATCH_H
+#define CEPH_MOSDOPBATCH_H
+
+#include <vector>
+
+#include "msg/Message.h"
+#include "include/encoding.h"
+
+/*
+ * Independent client ops to the same OSD, sent in a single message (see
+ * objecter_op_batch_max_ops). Each op is a complete CEPH_MSG_OSD_OP; the
+ * OSD unpacks the batch and dispatches, executes and replies to every op
+ * as if it had arrived on its own. Only sent to OSDs with
+ * CEPH_FEATURE_OSD_OP_BATCH.
+ */
+class MOSDOpBatch final : public Message {
+public:
+  static constexpr int HEAD_VERSION = 1;
+  static constexpr int COMPAT_VERSION = 1;
+
+  std::vector<ceph::ref_t<Message>> ops;
+
+  MOSDOpBatch() : Message{MSG_OSD_OP_BATCH, HEAD_VERSION, COMPAT_VERSION} {}
+private:
+  ~MOSDOpBatch() final {}
+
+public:
+  void encode_payload(uint64_t features) override {
+    using ceph::encode;
+    encode(static_cast<uint32_t>(ops.size()), payload);
+    for (auto& op : ops) {
+      encode_message(op.get(), features, payload);
+    }
+  }
+  void decode_payload() override {
+    using ceph::decode;
+    auto p = payload.cbegin();
+    uint32_t n;
+    decode(n, p);
+    ops.clear();
+    ops.reserve(n);
+    while (n--) {
+      ceph::ref_t<Message> op(decode_message(nullptr, 0, p), false);
+      if (!op || op->get_type() != CEPH_MSG_OSD_OP) {
+	throw ceph::buffer::malformed_input("MOSDOpBatch: expected an osd_op");
+      }
+      ops.push_back(std::move(op));
+    }
+  }
+
+  std::string_view get_type_name() const override { return "osd_op_batch"; }
+  void print(std::ostream& out) const override {
+    out << "osd_op_batch(" << ops.size() << " ops)";
+  }
+
+private:
+  template<class T, typename... Args>
+  friend boost::intrusive_ptr<T> ceph::make_message(Args&&... args);
+};
+
+#endif
@@ -157,6 +157,8 @@
 #define MSG_OSD_PG_LEASE        133
 #define MSG_OSD_PG_LEASE_ACK    134
 
+#define MSG_OSD_OP_BATCH        137
+
 // *** MDS ***
 
 #define MSG_MDS_BEACON             100  // to monitor
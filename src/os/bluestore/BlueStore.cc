@@ -6368,6 +6368,7 @@ void BlueStore::_init_logger()
 
   // Update op processing state latencies
   //****************************************
+  b.set_sharded(true);
   b.add_time_avg(l_bluestore_state_prepare_lat, "state_prepare_lat",
 		 "Average prepare state latency",
 		 "sprl", PerfCountersBuilder::PRIO_USEFUL);
@@ -6415,6 +6416,7 @@ void BlueStore::_init_logger()
 		 "Average commit latency",
 		 "c_l", PerfCountersBuilder::PRIO_CRITICAL);
   b.add_u64_counter(l_bluestore_txc, "txc_count", "Transactions committed");
+  b.set_sharded(false);
   //****************************************
 
   // Read op stats
@@ -87,6 +87,7 @@
 #include "messages/MOSDMarkMeDead.h"
 #include "messages/MOSDFull.h"
 #include "messages/MOSDOp.h"
+#include "messages/MOSDOpBatch.h"
 #include "messages/MOSDOpReply.h"
 #include "messages/MOSDBeacon.h"
 #include "messages/MOSDBoot.h"
@@ -2618,6 +2619,11 @@ int OSD::set_numa_affinity()
       } else {
 	dout(1) << __func__ << " objectstore and network numa nodes do not match"
 		<< dendl;
+	if (store_node >= 0 &&
+	    g_conf().get_val<int64_t>("osd_numa_node") < 0 &&
+	    g_conf().get_val<bool>("osd_numa_split_affinity")) {
+	  set_numa_split_affinity(front_node, store_node);
+	}
       }
     } else if (back_node == -2) {
       dout(1) << __func__ << " cluster network " << back_iface
@@ -2662,6 +2668,48 @@ int OSD::set_numa_affinity()
   return 0;
 }
 
+void OSD::set_numa_split_affinity(int network_node, int store_node)
+{
+  // keep the messenger workers next to the NIC and the op shards plus
+  // the objectstore threads next to the storage; memory those threads
+  // touch first is then allocated on their local node.
+  static const std::vector<std::string> network_threads = {
+    "msgr-worker-",
+  };
+  static const std::vector<std::string> store_threads = {
+    "tp_osd_tp",
+    "bstore_",
+  };
+  const struct {
+    int node;
+    const std::vector<std::string>& threads;
+    int OSD::*pinned_node;
+  } groups[] = {
+    {network_node, network_threads, &OSD::numa_network_node},
+    {store_node, store_threads, &OSD::numa_store_node},
+  };
+  for (const auto& [node, threads, pinned_node] : groups) {
+    size_t cpu_set_size = 0;
+    cpu_set_t cpu_set;
+    int r = get_numa_node_cpu_set(node, &cpu_set_size, &cpu_set);
+    if (r < 0) {
+      dout(1) << __func__ << " unable to determine numa node " << node
+	      << " CPUs" << dendl;
+      continue;
+    }
+    r = set_cpu_affinity_named_threads(threads, cpu_set_size, &cpu_set);
+    if (r < 0) {
+      derr << __func__ << " failed to set numa affinity for " << threads
+	   << " to node " << node << ": " << cpp_strerror(r) << dendl;
+      continue;
+    }
+    dout(1) << __func__ << " pinned " << r << " " << threads
+	    << " threads to numa node " << node << " cpus "
+	    << cpu_set_to_str_list(cpu_set_size, &cpu_set) << dendl;
+    this->*pinned_node = node;
+  }
+}
+
 // asok
 
 class OSDSocketHook : public AdminSocketHook {
@@ -7224,6 +7272,12 @@ void OSD::_collect_metadata(map<string,string> *pm)
     (*pm)["numa_node_cpus"] = cpu_set_to_str_list(numa_cpu_set_size,
 						  &numa_cpu_set);
   }
+  if (numa_network_node >= 0) {
+    (*pm)["numa_network_threads_node"] = stringify(numa_network_node);
+  }
+  if (numa_store_node >= 0) {
+    (*pm)["numa_objectstore_threads_node"] = stringify(numa_store_node);
+  }
 
   set<string> devnames;
   store->get_devices(&devnames);
@@ -7706,6 +7760,9 @@ void OSD::ms_fast_dispatch(Message *m)
   case MSG_OSD_SCRUB2:
     handle_fast_scrub(static_cast<MOSDScrub2*>(m));
     return;
+  case MSG_OSD_OP_BATCH:
+    handle_fast_op_batch(static_cast<MOSDOpBatch*>(m));
+    return;
   case MSG_OSD_PG_CREATE2:
     return handle_fast_pg_create(static_cast<MOSDPGCreate2*>(m));
   case MSG_OSD_PG_NOTIFY:
@@ -7869,6 +7926,23 @@ void OSD::_dispatch(Message *m)
   }
 }
 
+void OSD::handle_fast_op_batch(MOSDOpBatch *m)
+{
+  dout(15) << __func__ << " " << m->ops.size() << " ops from "
+	   << m->get_source() << dendl;
+  // every op is dispatched, executed and replied to on its own, as if it
+  // had arrived in a message of its own on this connection
+  for (auto& op : m->ops) {
+    op->set_connection(m->get_connection());
+    op->set_src(m->get_source());
+    op->set_recv_stamp(m->get_recv_stamp());
+    op->set_throttle_stamp(m->get_throttle_stamp());
+    op->set_recv_complete_stamp(m->get_recv_complete_stamp());
+    ms_fast_dispatch(op.detach());
+  }
+  m->put();
+}
+
 void OSD::handle_fast_scrub(MOSDScrub2 *m)
 {
   dout(10) << __func__ <<  " " << *m << dendl;
@@ -1291,6 +1291,11 @@ protected:
   size_t numa_cpu_set_size = 0;
   cpu_set_t numa_cpu_set;
 
+  // osd_numa_split_affinity: nodes the messenger and the op/objectstore
+  // threads were pinned to, if any
+  int numa_network_node = -1;
+  int numa_store_node = -1;
+
   bool store_is_rotational = true;
   bool journal_is_rotational = true;
 
@@ -2111,6 +2116,7 @@ private:
     switch (m->get_type()) {
     case CEPH_MSG_PING:
     case CEPH_MSG_OSD_OP:
+    case MSG_OSD_OP_BATCH:
     case CEPH_MSG_OSD_BACKOFF:
     case MSG_OSD_SCRUB2:
     case MSG_OSD_FORCE_RECOVERY:
@@ -2212,6 +2218,7 @@ private:
 			uuid_d& cluster_fsid, uuid_d& osd_fsid, int whoami, std::string& osdspec_affinity);
 
   void handle_fast_scrub(class MOSDScrub2 *m);
+  void handle_fast_op_batch(class MOSDOpBatch *m);
   void handle_osd_ping(class MOSDPing *m);
 
   size_t get_num_cache_shards();
@@ -2255,6 +2262,7 @@ public:
 
   int enable_disable_fuse(bool stop);
   int set_numa_affinity();
+  void set_numa_split_affinity(int network_node, int store_node);
 
   void suicide(int exitcode);
   int shutdown();
@@ -31,6 +31,7 @@
 
 #include "messages/MPing.h"
 #include "messages/MOSDOp.h"
+#include "messages/MOSDOpBatch.h"
 #include "messages/MOSDOpReply.h"
 #include "messages/MOSDBackoff.h"
 #include "messages/MOSDMap.h"
@@ -193,6 +194,9 @@ enum {
 
   l_osdc_split_op_reads,
 
+  l_osdc_op_batch_flush,
+  l_osdc_op_batched,
+
   l_osdc_last,
 };
 
@@ -410,6 +414,11 @@ void Objecter::init()
     pcb.add_u64_counter(l_osdc_split_op_reads, "split_op_reads",
                     "Client read ops split by SplitOp");
 
+    pcb.add_u64_counter(l_osdc_op_batch_flush, "op_batch_flush",
+			"Batches of small operations flushed to an OSD");
+    pcb.add_u64_counter(l_osdc_op_batched, "op_batched",
+			"Small operations sent as part of a batch");
+
     logger = pcb.create_perf_counters();
     cct->get_perfcounters_collection()->add(logger);
   }
@@ -442,6 +451,9 @@ void Objecter::start(const OSDMap* o)
   shared_lock rl(rwlock);
 
   start_tick();
+  if (op_batch_max_ops > 1) {
+    batch_timer.resume();
+  }
   if (o) {
     osdmap->deepish_copy_from(*o);
     prune_pg_mapping(osdmap->get_pools());
@@ -566,6 +578,8 @@ void Objecter::shutdown()
 
   // Let go of Objecter write lock so timer thread can shutdown
   wl.unlock();
+  batch_timer.suspend();
+  batch_timer.cancel_all_events();
 
   // Outside of lock to avoid cycle WRT calls to RequestStateHook
   // This is safe because we guarantee no concurrent calls to
@@ -2031,6 +2045,7 @@ void Objecter::close_session(OSDSession *s)
     _session_command_op_remove(s, i->second);
   }
 
+  s->batched_ops.clear();
   osd_sessions.erase(s->osd);
   sl.unlock();
   put_session(s);
@@ -2667,7 +2682,7 @@ void Objecter::_op_submit(Op *op, shunique_lock<ceph::shared_mutex>& sul, ceph_t
   }
 
   if (need_send) {
-    _send_op(op);
+    _send_op_maybe_batch(op);
   }
 
   // Last chance to touch Op here, after giving up session lock it can
@@ -3594,11 +3609,18 @@ Objecter::MOSDOp *Objecter::_prepare_osd_op(Op *op)
   return m;
 }
 
-void Objecter::_send_op(Op *op)
+void Objecter::_send_op(Op *op, MOSDOpBatch *batch)
 {
   // rwlock is locked
   // op->session->lock is locked
 
+  // anything batched ahead of us must hit the wire first to keep
+  // per-session ordering; if we were batched ourselves, we go now.
+  op->batched = false;
+  if (!batch && !op->session->batched_ops.empty()) {
+    _flush_op_batch(op->session, op->tid);
+  }
+
   // backoff?
   auto p = op->session->backoffs.find(op->target.actual_pgid);
   if (p != op->session->backoffs.end()) {
@@ -3664,7 +3686,104 @@ void Objecter::_send_op(Op *op)
   if (op->trace.valid()) {
     m->trace.init("op msg", nullptr, &op->trace);
   }
-  op->session->con->send_message(m);
+  if (batch) {
+    batch->ops.emplace_back(m, false);
+  } else {
+    op->session->con->send_message(m);
+  }
+}
+
+void Objecter::_send_op_maybe_batch(Op *op)
+{
+  // rwlock is locked
+  // op->session->lock is locked unique
+
+  OSDSession *s = op->session;
+  if (op_batch_max_ops <= 1 ||
+      !s->con || !s->con->has_features(CEPH_FEATUREMASK_OSD_OP_BATCH) ||
+      (uint64_t)calc_op_budget(op->ops) > op_batch_max_bytes) {
+    _send_op(op);
+    return;
+  }
+
+  ldout(cct, 20) << __func__ << " tid " << op->tid << " batched for osd."
+		 << s->osd << " (" << s->batched_ops.size() + 1 << " queued)"
+		 << dendl;
+  op->batched = true;
+  s->batched_ops.push_back(op->tid);
+  if (s->batched_ops.size() >= op_batch_max_ops) {
+    _flush_op_batch(s);
+  } else {
+    _schedule_op_batch_flush(s);
+  }
+}
+
+void Objecter::_flush_op_batch(OSDSession *s, ceph_tid_t upto)
+{
+  // rwlock is locked
+  // s->lock is locked unique
+
+  // batched_ops is in tid order; send everything below upto and drop
+  // upto itself, which the caller is sending directly
+  auto end = std::upper_bound(s->batched_ops.begin(), s->batched_ops.end(),
+			      upto);
+  std::vector<ceph_tid_t> tids(s->batched_ops.begin(), end);
+  s->batched_ops.erase(s->batched_ops.begin(), end);
+
+  if (tids.empty()) {
+    return;
+  }
+
+  // the session may have been reconnected to an OSD without batch
+  // support since the ops were queued
+  const bool can_batch = s->con &&
+    s->con->has_features(CEPH_FEATUREMASK_OSD_OP_BATCH);
+  auto batch = ceph::make_message<MOSDOpBatch>();
+  for (auto tid : tids) {
+    if (tid == upto) {
+      continue;
+    }
+    auto p = s->ops.find(tid);
+    if (p == s->ops.end() || !p->second->batched) {
+      // completed, canceled, remapped or already resent
+      continue;
+    }
+    _send_op(p->second, can_batch ? batch.get() : nullptr);
+  }
+  if (batch->ops.empty()) {
+    return;
+  }
+  if (batch->ops.size() == 1) {
+    s->con->send_message2(std::move(batch->ops.front()));
+    return;
+  }
+  ldout(cct, 15) << __func__ << " sending " << batch->ops.size()
+		 << " ops to osd." << s->osd << " in one message" << dendl;
+  logger->inc(l_osdc_op_batch_flush);
+  logger->inc(l_osdc_op_batched, batch->ops.size());
+  batch->set_priority(cct->_conf->osd_client_op_priority);
+  s->con->send_message2(std::move(batch));
+}
+
+void Objecter::_schedule_op_batch_flush(OSDSession *s)
+{
+  // s->lock is locked unique
+  if (s->batch_flush_scheduled) {
+    return;
+  }
+  s->batch_flush_scheduled = true;
+  batch_timer.add_event(
+    op_batch_window,
+    [this, s = ceph::ref_t<OSDSession>(s)] {
+      shared_lock rl(rwlock);
+      unique_lock sl(s->lock);
+      s->batch_flush_scheduled = false;
+      if (!initialized) {
+	s->batched_ops.clear();
+	return;
+      }
+      _flush_op_batch(s.get());
+    });
 }
 
 int Objecter::calc_op_budget(const bc::small_vector_base<OSDOp>& ops)
@@ -5465,6 +5584,11 @@ Objecter::Objecter(CephContext *cct,
   osd_timeout = cct->_conf.get_val<std::chrono::seconds>("rados_osd_op_timeout");
   min_split_replica_read_size
     = cct->_conf.get_val<uint64_t>("osd_min_split_replica_read_size");
+  op_batch_max_ops = cct->_conf.get_val<uint64_t>("objecter_op_batch_max_ops");
+  op_batch_max_bytes
+    = cct->_conf.get_val<Option::size_t>("objecter_op_batch_max_bytes");
+  op_batch_window = std::chrono::microseconds(
+    cct->_conf.get_val<uint64_t>("objecter_op_batch_window_us"));
 
   auto read_policy = cct->_conf.get_val<std::string>("rados_replica_read_policy");
   if (read_policy == "localize") {
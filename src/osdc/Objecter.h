@@ -16,6 +16,7 @@
 #ifndef CEPH_OBJECTER_H
 #define CEPH_OBJECTER_H
 
+#include <limits>
 #include <list>
 #include <map>
 #include <mutex>
@@ -71,6 +72,7 @@ class Messenger;
 class MonClient;
 class Message;
 
+class MOSDOpBatch;
 class MPoolOpReply;
 
 class MGetPoolStatsReply;
@@ -1831,6 +1833,13 @@ private:
 	   ceph::make_shared_mutex("Objecter::rwlock");
   ceph::timer<ceph::coarse_mono_clock> timer;
 
+  // small-op send batching (objecter_op_batch_*); the timer thread is
+  // only started when batching is enabled
+  ceph::timer<ceph::mono_clock> batch_timer{ceph::construct_suspended};
+  unsigned op_batch_max_ops = 0;
+  uint64_t op_batch_max_bytes = 0;
+  ceph::timespan op_batch_window;
+
   PerfCounters* logger = nullptr;
 
   uint64_t tick_event = 0;
@@ -2050,6 +2059,9 @@ public:
     /// true if we should resend this message on failure
     bool should_resend = true;
 
+    /// true while this op is queued in its session's send batch
+    bool batched = false;
+
     /// true if the throttle budget is get/put on a series of OPs,
     /// instead of per OP basis, when this flag is set, the budget is
     /// acquired before sending the very first OP of the series and
@@ -2510,6 +2522,11 @@ public:
 
     int incarnation;
     ConnectionRef con;
+
+    // tids of small ops held back to be sent together, in tid order
+    std::vector<ceph_tid_t> batched_ops;
+    bool batch_flush_scheduled = false;
+
     int num_locks;
     std::unique_ptr<std::mutex[]> completion_locks;
 
@@ -2576,7 +2593,11 @@ public:
   ceph::coarse_mono_time last_osdmap_request_time;
 
   MOSDOp *_prepare_osd_op(Op *op);
-  void _send_op(Op *op);
+  void _send_op(Op *op, MOSDOpBatch *batch = nullptr);
+  void _send_op_maybe_batch(Op *op);
+  void _flush_op_batch(OSDSession *s,
+		       ceph_tid_t upto = std::numeric_limits<ceph_tid_t>::max());
+  void _schedule_op_batch_flush(OSDSession *s);
   void _send_op_account(Op *op);
   void _cancel_linger_op(Op *op);
   void _finish_op(Op *op, int r);
@@ -424,8 +424,13 @@ bool LFUDAPolicy::update_refcount_if_key_exists(const DoutPrefixProvider* dpp, c
       refcount -= 1;
     }
   }
+  /* the heap only orders on whether the refcount is positive, so skip
+     reordering it unless the refcount moves to or from zero */
+  const bool reorder = (refcount == 0) != (entry->refcount == 0);
   (*entry->handle)->refcount = refcount;
-  entries_heap.update(entry->handle);
+  if (reorder) {
+    entries_heap.update(entry->handle);
+  }
   ldpp_dout(dpp, 20) << "LFUDAPolicy::" << __func__ << "(): updated refcount is: " << (*entry->handle)->refcount << dendl;
 
   return true;
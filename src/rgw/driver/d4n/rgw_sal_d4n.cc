@@ -14,9 +14,11 @@
  */
 
 #include "rgw_perf_counters.h"
+#include <boost/asio/spawn.hpp>
 #include <boost/redis/config.hpp>
 #include <boost/version.hpp>
 #include <memory>
+#include "include/scope_guard.h"
 #include "rgw_sal_d4n.h"
 
 namespace rgw { namespace sal {
@@ -1879,11 +1881,105 @@ std::unique_ptr<Writer> D4NFilterDriver::get_atomic_writer(const DoutPrefixProvi
   return std::make_unique<D4NFilterWriter>(std::move(writer), this, obj, dpp, true, y);
 }
 
+bool D4NFilterDriver::is_sequential_read(const std::string& prefix, uint64_t ofs, uint64_t end)
+{
+  uint64_t last_end = 0;
+  const bool sequential = read_ends.find(prefix, last_end) && ofs == last_end + 1;
+  read_ends.add(prefix, end);
+  return sequential;
+}
+
+/* On a cache miss of a sequential read, read the next rgw_d4n_prefetch_blocks
+   blocks of the object into the cache as well, so that the following request
+   of the stream is served from the cache. The blocks are read by a coroutine
+   on the driver's io_context, which works on its own copies of the object and
+   bucket because it outlives the request. Prefetches beyond
+   rgw_d4n_prefetch_max_requests at a time, or once shutdown() has started,
+   are skipped. */
+void D4NFilterDriver::prefetch(const DoutPrefixProvider* dpp, D4NFilterObject* source, uint64_t ofs)
+{
+  const uint64_t size = source->get_size();
+  if (ofs >= size) {
+    return;
+  }
+  const uint64_t max_chunk_size = std::min(g_conf()->rgw_max_chunk_size, size);
+  const uint64_t num_blocks = std::min<uint64_t>(g_conf()->rgw_d4n_prefetch_blocks,
+                                                 (size - ofs + max_chunk_size - 1) / max_chunk_size);
+  const uint64_t end = std::min(ofs + num_blocks * max_chunk_size, size) - 1;
+
+  const uint64_t first_len = std::min(max_chunk_size, size - ofs);
+  if (policyDriver->get_cache_policy()->exist_key(get_key_in_cache(source->get_prefix(), std::to_string(ofs), std::to_string(first_len)))) {
+    ldpp_dout(dpp, 20) << "D4NFilterDriver::" << __func__ << "(): block at ofs=" << ofs << " already cached" << dendl;
+    return;
+  }
+  {
+    std::lock_guard l{prefetch_lock};
+    if (prefetch_stopped) {
+      return;
+    }
+    if (prefetches >= g_conf()->rgw_d4n_prefetch_max_requests) {
+      ldpp_dout(dpp, 20) << "D4NFilterDriver::" << __func__ << "(): too many prefetches in flight, skipping ofs=" << ofs << dendl;
+      return;
+    }
+    ++prefetches;
+  }
+
+  auto bucket = source->get_bucket()->clone();
+  auto obj = std::make_unique<D4NFilterObject>(*source, this);
+  obj->set_bucket(bucket.get());
+  obj->set_object_version(source->get_object_version());
+  obj->set_prefix(source->get_prefix());
+
+  ldpp_dout(dpp, 20) << "D4NFilterDriver::" << __func__ << "(): prefetching " << num_blocks << " blocks from ofs=" << ofs << dendl;
+  boost::asio::spawn(io_context,
+    [this, cct = dpp->get_cct(), bucket = std::move(bucket), obj = std::move(obj),
+     ofs, end, num_blocks] (boost::asio::yield_context yield) {
+      auto done = make_scope_guard([this] {
+        std::lock_guard l{prefetch_lock};
+        if (--prefetches == 0) {
+          prefetch_cond.notify_all();
+        }
+      });
+      const DoutPrefix dp(cct, ceph_subsys_rgw, "D4N prefetch: ");
+      optional_yield y{yield};
+      auto read_op = obj->get_next()->get_read_op();
+      auto r = read_op->prepare(y, &dp);
+      if (r == 0) {
+        // no client callback, the data is only written to the cache
+        D4NFilterObject::D4NFilterReadOp::D4NFilterGetCB cb(this, obj.get());
+        cb.set_client_cb(nullptr, &dp, &y);
+        cb.set_adjusted_start_ofs(ofs);
+        r = read_op->iterate(&dp, ofs, end, &cb, y);
+        if (r == 0) {
+          r = cb.flush_last_part();
+        }
+      }
+      if (r < 0) {
+        ldpp_dout(&dp, 10) << "D4NFilterDriver::prefetch(): failed to prefetch from ofs=" << ofs << ", ret=" << r << dendl;
+        return;
+      }
+      if (perfcounter) {
+        perfcounter->inc(l_rgw_d4n_cache_prefetches, num_blocks);
+      }
+    }, boost::asio::detached);
+}
+
 void D4NFilterDriver::shutdown()
 {
+  {
+    std::lock_guard l{prefetch_lock};
+    prefetch_stopped = true;
+  }
+
   // call cancel() on the connection's executor
   boost::asio::dispatch(conn->get_executor(), [c = conn] { c->cancel(); });
 
+  // the prefetches use the drivers and directories reset below
+  {
+    std::unique_lock l{prefetch_lock};
+    prefetch_cond.wait(l, [this] { return prefetches == 0; });
+  }
+
   cacheDriver.reset();
   objDir.reset();
   blockDir.reset();
@@ -2167,6 +2263,9 @@ int D4NFilterObject::D4NFilterReadOp::iterate(const DoutPrefixProvider* dpp, int
   this->cb->set_client_cb(cb, dpp, &y);
   source->set_prefix(prefix);
 
+  const bool sequential = g_conf()->rgw_d4n_prefetch_blocks > 0 && !params.part_num &&
+    source->driver->is_sequential_read(prefix, ofs, end);
+
   uint64_t max_chunk_size = std::min(g_conf()->rgw_max_chunk_size, source->get_size());
   uint64_t start_part_num = 0;
   uint64_t part_num = ofs/max_chunk_size; //part num of ofs wrt start of the object
@@ -2327,7 +2426,14 @@ int D4NFilterObject::D4NFilterReadOp::iterate(const DoutPrefixProvider* dpp, int
   }
   /* Copy params out of next */
   params = next->params;
-  return this->cb->flush_last_part();
+  r = this->cb->flush_last_part();
+  if (r < 0) {
+    return r;
+  }
+  if (sequential && !source->dest_object) {
+    source->driver->prefetch(dpp, source, adjusted_end_ofs + 1);
+  }
+  return 0;
 }
 
 int D4NFilterObject::D4NFilterReadOp::get_attr(const DoutPrefixProvider* dpp, const char* name, bufferlist& dest, optional_yield y)
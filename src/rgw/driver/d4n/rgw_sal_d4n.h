@@ -19,6 +19,8 @@
 #include "rgw_sal.h"
 #include "rgw_role.h"
 #include "common/dout.h" 
+#include "common/lru_map.h"
+#include "common/ceph_mutex.h"
 #include "rgw_aio_throttle.h"
 #include "rgw_ssd_driver.h"
 #include "rgw_redis_driver.h"
@@ -51,6 +53,8 @@ inline std::string get_key_in_cache(const std::string& prefix, const std::string
 
 using boost::redis::connection;
 
+class D4NFilterObject;
+
 class D4NFilterDriver : public FilterDriver {
   private:
     std::shared_ptr<connection> conn;
@@ -65,6 +69,16 @@ class D4NFilterDriver : public FilterDriver {
     // Redis connection pool
     std::shared_ptr<rgw::d4n::RedisPool> redis_pool;
 
+    // end offset of the last read of recently read objects, keyed by
+    // cache block prefix, used to detect sequential reads
+    lru_map<std::string, uint64_t> read_ends{1024};
+    // prefetches running in the background; shutdown() waits for them
+    // to finish before tearing down what they use
+    ceph::mutex prefetch_lock = ceph::make_mutex("D4NFilterDriver::prefetch_lock");
+    ceph::condition_variable prefetch_cond;
+    uint64_t prefetches = 0;
+    bool prefetch_stopped = false;
+
   public:
     D4NFilterDriver(Driver* _next, boost::asio::io_context& io_context, bool admin);
     virtual ~D4NFilterDriver();
@@ -91,6 +105,18 @@ class D4NFilterDriver : public FilterDriver {
     void save_y(optional_yield y) { this->y = y; }
     std::shared_ptr<connection> get_conn() { return conn; }
     std::shared_ptr<rgw::d4n::RedisPool> get_redis_pool() { return redis_pool; }
+    // record a read of [ofs, end] and return whether it continues the
+    // previous read of the same object
+    bool is_sequential_read(const std::string& prefix, uint64_t ofs, uint64_t end);
+    // read the blocks of the object following ofs into the cache in the
+    // background, without holding up the request that triggered it
+    void prefetch(const DoutPrefixProvider* dpp, D4NFilterObject* source, uint64_t ofs);
+    uint64_t get_prefetches() {
+      std::lock_guard l{prefetch_lock};
+      return prefetches;
+    }
+    // waits for running prefetches, so it must not be called from the only
+    // thread running the io_context while any are in flight
     void shutdown() override;
 };
 
@@ -285,18 +285,26 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
 
 bool D3nDataCache::get(const string& oid, const off_t len)
 {
-  const std::lock_guard l(d3n_cache_lock);
   bool exist = false;
   std::string digest_oid = D3nL1CacheRequest::generate_oid_digest(oid);
   string location = cache_location + digest_oid;
 
   lsubdout(g_ceph_context, rgw_datacache, 20) << "D3nDataCache: " << __func__ << "(): oid=" << oid << ", digest_oid=" << digest_oid << ", location=" << location << dendl;
+  {
+    const std::lock_guard l(d3n_cache_lock);
+    if (d3n_cache_map.find(digest_oid) == d3n_cache_map.end()) {
+      return false;
+    }
+  }
+  // check inside cache whether file exists or not, without holding the
+  // cache lock across the syscall
+  struct stat st;
+  int r = stat(location.c_str(), &st);
+
+  const std::lock_guard l(d3n_cache_lock);
   std::unordered_map<string, D3nChunkDataInfo*>::iterator iter = d3n_cache_map.find(digest_oid);
   if (!(iter == d3n_cache_map.end())) {
-    // check inside cache whether file exists or not!!!! then make exist true;
     struct D3nChunkDataInfo* chdo = iter->second;
-    struct stat st;
-    int r = stat(location.c_str(), &st);
     if ( r != -1 && st.st_size == len) { // file exists and contains required data range length
       exist = true;
       /*LRU*/
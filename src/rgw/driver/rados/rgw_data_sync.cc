@@ -4081,6 +4081,12 @@ public:
 
   int operate(const DoutPrefixProvider *dpp) override {
     reenter(this) {
+      if (cct->_conf->rgw_sync_bucket_list_inject_err_probability > 0 &&
+          rand() % 10000 < cct->_conf->rgw_sync_bucket_list_inject_err_probability * 10000.0) {
+        ldpp_dout(dpp, 0) << "injecting remote bucket listing error on "
+            << bs << " marker=" << marker_position << dendl;
+        return set_cr_error(-EIO);
+      }
       yield {
         rgw_http_param_pair pairs[] = { { "versions" , NULL },
 					{ "format" , "json" },
@@ -4551,6 +4557,15 @@ class RGWBucketFullSyncCR : public RGWCoroutine {
   rgw_obj_key list_marker;
   bucket_list_entry *entry{nullptr};
 
+  // the next page of the listing is requested while the current page's
+  // entries are being synced
+  boost::intrusive_ptr<RGWCoroutine> prefetch_cr;
+  int64_t prefetch_stack_id{-1};
+  rgw_obj_key prefetch_marker;
+  bucket_list_result prefetch_result;
+  bool use_prefetch{false};
+  size_t drain_target{0};
+
   int total_entries{0};
 
   int sync_result{0};
@@ -4628,6 +4643,18 @@ public:
   }
 
   int operate(const DoutPrefixProvider *dpp) override;
+
+private:
+  int handle_child_result(uint64_t stack_id, int ret) {
+    if (prefetch_cr && stack_id == (uint64_t)prefetch_stack_id) {
+      return 0; // listing errors are handled when the page is consumed
+    }
+    if (ret < 0) {
+      tn->log(10, "a sync operation returned error");
+      sync_result = ret;
+    }
+    return 0;
+  }
 };
 
 int RGWBucketFullSyncCR::operate(const DoutPrefixProvider *dpp)
@@ -4656,7 +4683,29 @@ int RGWBucketFullSyncCR::operate(const DoutPrefixProvider *dpp)
         break;
       }
 
-      yield call(new RGWListRemoteBucketCR(sc, bs, list_marker, &list_result));
+      if (prefetch_cr) {
+        // wait for the prefetched page, syncing entries in the meantime
+        while (!prefetch_cr->is_done()) {
+          drain_target = num_spawned() - 1;
+          drain_with_cb(drain_target,
+                        [&](uint64_t stack_id, int ret) {
+                          return handle_child_result(stack_id, ret);
+                        });
+        }
+        // unless the prefix rules moved the marker past the prefetched page
+        use_prefetch = (list_marker == prefetch_marker);
+        if (use_prefetch) {
+          retcode = prefetch_cr->get_ret_status();
+          std::swap(list_result, prefetch_result);
+        }
+        prefetch_cr.reset();
+        prefetch_stack_id = -1;
+      } else {
+        use_prefetch = false;
+      }
+      if (!use_prefetch) {
+        yield call(new RGWListRemoteBucketCR(sc, bs, list_marker, &list_result));
+      }
       if (retcode < 0 && retcode != -ENOENT) {
         tn->log(5, SSTR("failed bucket listing retcode=" << retcode));
         set_status("failed bucket listing, going down");
@@ -4672,6 +4721,13 @@ int RGWBucketFullSyncCR::operate(const DoutPrefixProvider *dpp)
         tn->set_flag(RGW_SNS_FLAG_ACTIVE); /* actually have entries to sync */
       }
 
+      if (list_result.is_truncated && !list_result.entries.empty()) {
+        prefetch_marker = list_result.entries.back().key;
+        prefetch_cr.reset(new RGWListRemoteBucketCR(sc, bs, prefetch_marker,
+                                                    &prefetch_result));
+        prefetch_stack_id = spawn(prefetch_cr.get(), false)->get_id();
+      }
+
       entries_iter = list_result.entries.begin();
       for (; entries_iter != list_result.entries.end(); ++entries_iter) {
         if (lease_cr && !lease_cr->is_locked()) {
@@ -4718,14 +4774,11 @@ int RGWBucketFullSyncCR::operate(const DoutPrefixProvider *dpp)
                                  entry->key, &marker_tracker, zones_trace, tn),
                       false);
         }
-        drain_with_cb(sc->lcc.adj_concurrency(cct->_conf->rgw_bucket_sync_spawn_window),
+        drain_with_cb(sc->lcc.adj_concurrency(cct->_conf->rgw_bucket_sync_spawn_window) +
+                      (prefetch_cr && !prefetch_cr->is_done() ? 1 : 0),
                       [&](uint64_t stack_id, int ret) {
-                if (ret < 0) {
-                  tn->log(10, "a sync operation returned error");
-                  sync_result = ret;
-                }
-                return 0;
-              });
+                        return handle_child_result(stack_id, ret);
+                      });
       }
     } while (list_result.is_truncated && sync_result == 0);
     set_status("done iterating over all objects");
@@ -4734,12 +4787,9 @@ int RGWBucketFullSyncCR::operate(const DoutPrefixProvider *dpp)
 
     /* wait for all operations to complete */
     drain_all_cb([&](uint64_t stack_id, int ret) {
-      if (ret < 0) {
-        tn->log(10, "a sync operation returned error");
-        sync_result = ret;
-      }
-      return 0;
+      return handle_child_result(stack_id, ret);
     });
+    prefetch_cr.reset();
     tn->unset_flag(RGW_SNS_FLAG_ACTIVE);
     if (lease_cr && !lease_cr->is_locked()) {
       tn->log(1, "no lease or lease is lost, abort");
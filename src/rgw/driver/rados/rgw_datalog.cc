@@ -39,6 +39,7 @@
 #include "rgw_bucket_layout.h"
 #include "rgw_datalog.h"
 #include "rgw_log_backing.h"
+#include "rgw_perf_counters.h"
 #include "rgw_tools.h"
 #include "rgw_sal_rados.h"
 
@@ -382,7 +383,9 @@ RGWDataChangesLog::RGWDataChangesLog(rgw::sal::RadosStore* driver)
     executor(driver->get_io_context().get_executor()),
     num_shards(cct->_conf->rgw_data_log_num_shards),
     prefix(get_prefix()),
-    changes(cct->_conf->rgw_data_log_changes_size) {}
+    changes(cct->_conf->rgw_data_log_changes_size) {
+  init_group_commits();
+}
 
 RGWDataChangesLog::RGWDataChangesLog(CephContext *cct, bool log_data,
                                      neorados::RADOS rados,
@@ -392,7 +395,17 @@ RGWDataChangesLog::RGWDataChangesLog(CephContext *cct, bool log_data,
       num_shards(num_shards ? *num_shards :
 		 cct->_conf->rgw_data_log_num_shards),
       prefix(get_prefix()), changes(cct->_conf->rgw_data_log_changes_size),
-      sem_max_keys(sem_max_keys ? *sem_max_keys : ss::max_keys) {}
+      sem_max_keys(sem_max_keys ? *sem_max_keys : ss::max_keys) {
+  init_group_commits();
+}
+
+void RGWDataChangesLog::init_group_commits()
+{
+  group_commits.reserve(num_shards);
+  for (auto i = 0; i < num_shards; ++i) {
+    group_commits.push_back(std::make_unique<GroupCommit>(executor));
+  }
+}
 
 
 void DataLogBackends::handle_init(entries_t e) {
@@ -1001,10 +1014,9 @@ void RGWDataChangesLog::add_entry(const DoutPrefixProvider* dpp,
 
   ldpp_dout(dpp, 20) << "RGWDataChangesLog::add_entry() sending update with now=" << now << " cur_expiration=" << expiration << dendl;
 
-  auto be = bes->head();
   // Failure on push isn't fatal.
   try {
-    be->push(dpp, index, now, change.key, std::move(bl), y);
+    push_grouped(dpp, index, now, std::move(change.key), std::move(bl), y);
   } catch (const std::exception& e) {
     ldpp_dout(dpp, 5) << "RGWDataChangesLog::add_entry(): Backend push failed "
 		      << "with exception: " << e.what() << dendl;
@@ -1025,6 +1037,74 @@ void RGWDataChangesLog::add_entry(const DoutPrefixProvider* dpp,
   return;
 }
 
+void RGWDataChangesLog::push_grouped(const DoutPrefixProvider* dpp, int index,
+				     ceph::real_time now, std::string&& key,
+				     buffer::list&& bl, asio::yield_context y)
+{
+  const auto window = std::chrono::milliseconds(
+    cct->_conf.get_val<uint64_t>("rgw_data_log_group_commit_window_ms"));
+  if (window == window.zero()) {
+    bes->head()->push(dpp, index, now, key, std::move(bl), y);
+    return;
+  }
+
+  auto& g = *group_commits[index];
+  std::unique_lock l(g.lock);
+  const auto seq = g.open_seq; // the group we join
+  g.entries.push_back({now, std::move(key), std::move(bl)});
+  if (g.leader) {
+    // another writer leads this group, or is still writing the previous
+    // one and hands ours over to one of its writers when it is done
+    while (g.done_seq <= seq && g.leader) {
+      g.cond.async_wait(l, y);
+    }
+    if (g.done_seq > seq) {
+      return;
+    }
+    // ours formed while the previous group was written, so it's pushed
+    // without waiting for more writers to join
+    g.leader = true;
+  } else {
+    g.leader = true;
+    l.unlock();
+    asio::steady_timer timer(y.get_executor(), window);
+    sys::error_code ec;
+    timer.async_wait(y[ec]);
+    l.lock();
+  }
+
+  auto entries = std::move(g.entries);
+  g.entries.clear();
+  ++g.open_seq; // later writers start the next group
+  l.unlock();
+
+  auto be = bes->head();
+  RGWDataChangesBE::entries items;
+  for (auto& e : entries) {
+    be->prepare(e.timestamp, e.key, std::move(e.bl), items);
+  }
+  // Failure on push isn't fatal, for any writer in the group.
+  try {
+    asio::co_spawn(y.get_executor(), be->push(dpp, index, std::move(items)),
+		   y);
+  } catch (const std::exception& e) {
+    ldpp_dout(dpp, 5) << "RGWDataChangesLog::push_grouped(): Backend push "
+		      << "of " << entries.size() << " entries failed with "
+		      << "exception: " << e.what() << dendl;
+  }
+  if (perfcounter) {
+    perfcounter->inc(l_rgw_datalog_group_writes);
+    perfcounter->inc(l_rgw_datalog_group_entries, entries.size());
+  }
+
+  // a leader writes a single group so that its own request isn't held up
+  // by a steady stream of writers; a writer of the next group takes over
+  l.lock();
+  ++g.done_seq;
+  g.leader = false;
+  g.cond.notify(l);
+}
+
 int RGWDataChangesLog::add_entry(const DoutPrefixProvider* dpp,
 				 const RGWBucketInfo& bucket_info,
 				 const rgw::bucket_log_layout_generation& gen,
@@ -400,6 +400,32 @@ class RGWDataChangesLog {
 
   using ChangeStatusPtr = std::shared_ptr<ChangeStatus>;
 
+  // entries that add_entry() writes to the same log shard at about the
+  // same time are committed together. the first writer leads the group:
+  // it waits rgw_data_log_group_commit_window_ms for others to join and
+  // pushes all of their entries at once, while they wait for it to finish.
+  // writers arriving meanwhile form the next group, which one of them leads
+  struct GroupCommit {
+    struct Entry {
+      ceph::real_time timestamp;
+      std::string key;
+      ceph::buffer::list bl;
+    };
+    std::mutex lock;
+    ceph::async::async_cond<executor_t> cond;
+    std::vector<Entry> entries;
+    bool leader = false;
+    uint64_t open_seq = 0; // the group new entries join
+    uint64_t done_seq = 0; // groups before this one are committed
+
+    explicit GroupCommit(executor_t executor) : cond(executor) {}
+  };
+  std::vector<std::unique_ptr<GroupCommit>> group_commits;
+  void init_group_commits();
+  void push_grouped(const DoutPrefixProvider* dpp, int index,
+		    ceph::real_time now, std::string&& key,
+		    ceph::buffer::list&& bl, asio::yield_context y);
+
   lru_map<BucketGen, ChangeStatusPtr> changes;
   const uint64_t sem_max_keys = neorados::cls::sem_set::max_keys;
 
@@ -58,6 +58,7 @@
 #include <cinttypes>
 #include <cstring>
 #include <span>
+#include <deque>
 #include <mutex>
 #include <thread>
 
@@ -1088,6 +1089,7 @@ namespace rgw::dedup {
   int Background::calc_object_blake3(const RGWObjManifest &manifest,
                                      disk_record_t *p_rec,
                                      uint8_t *p_hash,
+                                     md5_stats_t *p_stats,
                                      blake3_hasher *p_pre_calc_hmac)
   {
     ldpp_dout(dpp, 20) << __func__ << "::p_rec->obj_name=" << p_rec->obj_name << dendl;
@@ -1101,36 +1103,81 @@ namespace rgw::dedup {
       p_hmac = p_pre_calc_hmac;
     }
 
-    for (auto p = manifest.obj_begin(dpp); p != manifest.obj_end(dpp); ++p) {
+    // Keep tail-object reads in flight so the RADOS reads overlap with hashing
+    // the data which already arrived. Reads may complete out of order, but the
+    // hash must be updated in order, so completed reads wait in ready_reads
+    std::unique_ptr<rgw::Aio> aio = rgw::make_throttle(cct->_conf->rgw_max_copy_obj_concurrent_io, null_yield);
+    std::map<uint64_t, bufferlist> ready_reads;
+    uint64_t next_read = 0, read_id = 0;
+    uint64_t hashed_bytes = 0;
+    ceph::timespan hash_time = ceph::timespan::zero();
+    int ret = 0;
+
+    // feed the data of the reads which completed in order to the hash
+    auto handle_completed = [&] (rgw::AioResultList&& completed) {
+      for (auto& r : completed) {
+        if (unlikely(r.result < 0)) {
+          ldpp_dout(dpp, 1) << __func__ << "::ERR: failed to read oid "
+                            << r.obj.oid << ", err is " << cpp_strerror(-r.result) << dendl;
+          if (ret == 0) {
+            ret = r.result;
+          }
+        }
+        else {
+          ready_reads.emplace(r.id, std::move(r.data));
+        }
+      }
+      while (ret == 0 && !ready_reads.empty() &&
+             ready_reads.begin()->first == next_read) {
+        const auto& bl = ready_reads.begin()->second;
+        const auto hash_start = ceph::mono_clock::now();
+        for (const auto& bptr : bl.buffers()) {
+          blake3_hasher_update(p_hmac, (const unsigned char *)bptr.c_str(), bptr.length());
+        }
+        hash_time += ceph::mono_clock::now() - hash_start;
+        hashed_bytes += bl.length();
+        ready_reads.erase(ready_reads.begin());
+        next_read++;
+      }
+    };
+
+    for (auto p = manifest.obj_begin(dpp); p != manifest.obj_end(dpp) && ret == 0; ++p) {
       uint64_t offset = p.get_stripe_ofs();
       const rgw_obj_select& os = p.get_location();
       if (offset > 0 || !p_pre_calc_hmac) {
         rgw_raw_obj raw_obj = os.get_raw_obj(rados);
         rgw_rados_ref obj;
-        int ret = rgw_get_rados_ref(dpp, rados_handle, raw_obj, &obj);
+        ret = rgw_get_rados_ref(dpp, rados_handle, raw_obj, &obj);
         if (ret < 0) {
           ldpp_dout(dpp, 1) << __func__ << "::failed rgw_get_rados_ref() for oid="
                             << raw_obj.oid << ", err is " << cpp_strerror(-ret) << dendl;
-          return ret;
+          break;
         }
 
-        librados::IoCtx ioctx = obj.ioctx;
-        bufferlist bl;
         // read full object
-        ret = ioctx.read(raw_obj.oid, bl, 0, 0);
-        if (unlikely(ret <= 0)) {
-          ldpp_dout(dpp, 1) << __func__ << "::ERR: failed to read oid "
-                            << raw_obj.oid  << ", err is " << cpp_strerror(-ret) << dendl;
-          return ret;
-        }
-        for (const auto& bptr : bl.buffers()) {
-          blake3_hasher_update(p_hmac, (const unsigned char *)bptr.c_str(), bptr.length());
-        }
+        ObjectReadOperation op;
+        op.read(0, 0, nullptr, nullptr);
+        handle_completed(aio->get(obj.obj,
+                                  rgw::Aio::librados_op(obj.ioctx, std::move(op), null_yield),
+                                  1, read_id++));
       }
     }
+    // the pending reads write into the throttle's buffers, always wait for them
+    handle_completed(aio->drain());
+    if (ret < 0) {
+      return ret;
+    }
+
+    const auto hash_start = ceph::mono_clock::now();
     blake3_hasher_finalize(p_hmac, p_hash, BLAKE3_OUT_LEN);
+    hash_time += ceph::mono_clock::now() - hash_start;
     p_rec->s.flags.set_hash_calculated();
     p_rec->s.flags.set_has_valid_hash();
+    p_stats->calc_hash_objs++;
+    p_stats->calc_hash_bytes += hashed_bytes;
+    // only the hashing, not the wait for the reads
+    p_stats->calc_hash_time_usec +=
+      std::chrono::duration_cast<std::chrono::microseconds>(hash_time).count();
     return 0;
   }
 
@@ -1318,7 +1365,7 @@ namespace rgw::dedup {
     if (!need_to_split_head) {
       ldpp_dout(dpp, 20) << __func__ << "::CALC Object Strong Hash::"
                          << p_rec->obj_name << dendl;
-      return calc_object_blake3(manifest, p_rec, (uint8_t*)p_rec->s.hash);
+      return calc_object_blake3(manifest, p_rec, (uint8_t*)p_rec->s.hash, p_stats);
     }
     // else, differ strong-hash calculation for next step and piggy back split-head
     return 0;
@@ -1716,7 +1763,7 @@ namespace rgw::dedup {
                              bptr.length());
       }
       uint8_t *p_hash = (uint8_t*)p_src_rec->s.hash;
-      ret = calc_object_blake3(src_manifest, p_src_rec, p_hash, &hmac);
+      ret = calc_object_blake3(src_manifest, p_src_rec, p_hash, p_stats, &hmac);
       if (unlikely(ret != 0)) {
         return ret;
       }
@@ -1795,7 +1842,7 @@ namespace rgw::dedup {
     if (!p_tgt_rec->s.flags.has_valid_hash()) {
       ldpp_dout(dpp, 20) << __func__ << "::CALC TGT Strong Hash::"
                          << p_tgt_rec->obj_name << dendl;
-      ret = calc_object_blake3(tgt_manifest, p_tgt_rec, (uint8_t*)p_tgt_rec->s.hash);
+      ret = calc_object_blake3(tgt_manifest, p_tgt_rec, (uint8_t*)p_tgt_rec->s.hash, p_stats);
       if (unlikely(ret != 0)) {
         // Don't run dedup without a valid strong hash
         return false;
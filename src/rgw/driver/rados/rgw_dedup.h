@@ -191,6 +191,7 @@ namespace rgw::dedup {
     int calc_object_blake3(const RGWObjManifest &manifest,
                            disk_record_t *p_rec,
                            uint8_t *p_hash,
+                           md5_stats_t *p_stats /* IN-OUT */,
                            blake3_hasher *p_pre_calc_hmac = nullptr);
     int split_head_object(disk_record_t *p_src_rec,     // IN/OUT PARAM
                           RGWObjManifest &src_manifest, // IN/OUT PARAM
@@ -607,6 +607,9 @@ namespace rgw::dedup {
     this->md_throttle_sleep_time_usec += other.md_throttle_sleep_time_usec;
     this->failed_table_load       += other.failed_table_load;
     this->failed_map_overflow     += other.failed_map_overflow;
+    this->calc_hash_objs          += other.calc_hash_objs;
+    this->calc_hash_bytes         += other.calc_hash_bytes;
+    this->calc_hash_time_usec     += other.calc_hash_time_usec;
     return *this;
   }
 
@@ -665,6 +668,16 @@ namespace rgw::dedup {
       if (this->set_hash_attrs) {
         f->dump_unsigned("Set HASH", this->set_hash_attrs);
       }
+      if (this->calc_hash_objs) {
+        f->dump_unsigned("Calculated HASH objs", this->calc_hash_objs);
+        f->dump_unsigned("Calculated HASH Bytes", this->calc_hash_bytes);
+        f->dump_unsigned("Calculated HASH Time (msec)", this->calc_hash_time_usec/1000);
+        if (this->calc_hash_time_usec) {
+          // bytes per usec is MB/sec
+          f->dump_unsigned("Calculated HASH Throughput (MB/sec)",
+                           this->calc_hash_bytes/this->calc_hash_time_usec);
+        }
+      }
 
       if (this->skip_shared_tail_objs) {
         f->dump_unsigned("Skip Shared Tail Objs (server-side-copy)", this->skip_shared_tail_objs);
@@ -808,7 +821,7 @@ namespace rgw::dedup {
   //---------------------------------------------------------------------------
   void encode(const md5_stats_t& m, ceph::bufferlist& bl)
   {
-    ENCODE_START(1, 1, bl);
+    ENCODE_START(2, 1, bl);
 
     encode(m.big_objs_stat, bl);
     encode(m.ingress_slabs, bl);
@@ -873,13 +886,16 @@ namespace rgw::dedup {
     encode(m.failed_map_overflow, bl);
 
     encode(m.duration, bl);
+    encode(m.calc_hash_objs, bl);
+    encode(m.calc_hash_bytes, bl);
+    encode(m.calc_hash_time_usec, bl);
     ENCODE_FINISH(bl);
   }
 
   //---------------------------------------------------------------------------
   void decode(md5_stats_t& m, ceph::bufferlist::const_iterator& bl)
   {
-    DECODE_START(1, bl);
+    DECODE_START(2, bl);
     decode(m.big_objs_stat, bl);
     decode(m.ingress_slabs, bl);
     decode(m.ingress_failed_load_bucket, bl);
@@ -943,6 +959,11 @@ namespace rgw::dedup {
     decode(m.failed_map_overflow, bl);
 
     decode(m.duration, bl);
+    if (struct_v >= 2) {
+      decode(m.calc_hash_objs, bl);
+      decode(m.calc_hash_bytes, bl);
+      decode(m.calc_hash_time_usec, bl);
+    }
     DECODE_FINISH(bl);
   }
 } //namespace rgw::dedup
@@ -274,6 +274,10 @@ namespace rgw::dedup {
     uint64_t md_throttle_sleep_time_usec = 0;
     uint64_t failed_table_load = 0;
     uint64_t failed_map_overflow = 0;
+    // strong-hash (BLAKE3) calculation over object data
+    uint64_t calc_hash_objs = 0;
+    uint64_t calc_hash_bytes = 0;
+    uint64_t calc_hash_time_usec = 0;
     utime_t  duration = {0, 0};
   };
   std::ostream &operator<<(std::ostream &out, const md5_stats_t &s);
@@ -16,10 +16,14 @@
 #include "include/random.h"
 #include "rgw_gc_log.h"
 
+#include <algorithm>
 #include <list> // XXX
+#include <map>
 #include <sstream>
 #include "xxhash.h"
 
+#include <boost/asio/post.hpp>
+
 #define dout_context g_ceph_context
 #define dout_subsys ceph_subsys_rgw
 
@@ -36,6 +40,7 @@ void RGWGC::initialize(CephContext *_cct, RGWRados *_store, optional_yield y) {
   max_objs = min(static_cast<int>(cct->_conf->rgw_gc_max_objs), rgw_shards_max());
 
   obj_names = new string[max_objs];
+  transitioned_objects_cache = std::make_unique<std::atomic<bool>[]>(max_objs);
 
   for (int i = 0; i < max_objs; i++) {
     obj_names[i] = gc_oid_prefix;
@@ -43,9 +48,6 @@ void RGWGC::initialize(CephContext *_cct, RGWRados *_store, optional_yield y) {
     snprintf(buf, 32, ".%d", i);
     obj_names[i].append(buf);
 
-    auto it = transitioned_objects_cache.begin() + i;
-    transitioned_objects_cache.insert(it, false);
-
     //version = 0 -> not ready for transition
     //version = 1 -> marked ready for transition
     librados::ObjectWriteOperation op;
@@ -296,10 +298,11 @@ class RGWGCIOManager {
   size_t max_aio{MAX_AIO_DEFAULT};
 
 public:
-  RGWGCIOManager(const DoutPrefixProvider* _dpp, CephContext *_cct, RGWGC *_gc) : dpp(_dpp),
-                                                                                  cct(_cct),
-                                                                                  gc(_gc) {
-    max_aio = cct->_conf->rgw_gc_max_concurrent_io;
+  RGWGCIOManager(const DoutPrefixProvider* _dpp, CephContext *_cct, RGWGC *_gc,
+                 size_t _max_aio) : dpp(_dpp),
+                                    cct(_cct),
+                                    gc(_gc),
+                                    max_aio(_max_aio) {
     // must match obj_names[] / transitioned_objects_cache sized in initialize()
     remove_tags.resize(gc->get_max_objs());
     tag_io_size.resize(gc->get_max_objs());
@@ -360,6 +363,10 @@ public:
       goto done;
     }
 
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_gc_tail_removed);
+    }
+
     if (! gc->transitioned_objects_cache[io.index]) {
       schedule_tag_removal(io.index, io.tag);
     }
@@ -512,7 +519,10 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
   string marker;
   string next_marker;
   bool truncated = false;
-  IoCtx *ctx = new IoCtx;
+  // tail objects of a chain usually share a pool, but keep one IoCtx per
+  // pool rather than re-creating it whenever the pool changes between
+  // consecutive objects
+  std::map<std::string, IoCtx> pool_ctxs;
   do {
     int max = 100;
     std::list<cls_rgw_gc_obj_info> entries;
@@ -562,7 +572,6 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
 
     marker = next_marker;
 
-    string last_pool;
     std::list<cls_rgw_gc_obj_info>::iterator iter;
     for (iter = entries.begin(); iter != entries.end(); ++iter) {
       cls_rgw_gc_obj_info& info = *iter;
@@ -586,24 +595,24 @@ int RGWGC::process(int index, int max_secs, bool expired_only,
       }
       if (! chain.objs.empty()) {
 	for (const auto& obj : chain.objs) {
-	  if (obj.pool != last_pool) {
-	    delete ctx;
-	    ctx = new IoCtx;
-	    ret = rgw_init_ioctx(this, store->get_rados_handle(), obj.pool, *ctx);
+	  auto pc = pool_ctxs.find(obj.pool);
+	  if (pc == pool_ctxs.end()) {
+	    IoCtx pool_ctx;
+	    ret = rgw_init_ioctx(this, store->get_rados_handle(), obj.pool, pool_ctx);
 	    if (ret < 0) {
         if (transitioned_objects_cache[index]) {
           goto done;
         }
-	      last_pool = "";
 	      ldpp_dout(this, 0) << "ERROR: failed to create ioctx pool=" <<
 		obj.pool << dendl;
 	      continue;
 	    }
-	    last_pool = obj.pool;
+	    pool_ctx.set_pool_full_try(); // allow deletion at pool quota limit
+	    pc = pool_ctxs.emplace(obj.pool, std::move(pool_ctx)).first;
 	  }
+	  IoCtx* ctx = &pc->second;
 
 	  ctx->locator_set_key(obj.loc);
-	  ctx->set_pool_full_try(); // allow deletion at pool quota limit
 
 	  const string& oid = obj.key.name; /* just stored raw oid there */
 
@@ -650,30 +659,96 @@ done:
    * hold the system if backend is unresponsive
    */
   l.unlock(&store->gc_pool_ctx, obj_names[index]);
-  delete ctx;
 
   return 0;
 }
 
+int gc_walk_shards(ceph::async::io_context_pool* pool, int num_workers,
+                   int num_shards, int start,
+                   const std::function<int(int, int)>& process,
+                   const std::function<void(int)>& finish,
+                   const std::function<bool()>& stop)
+{
+  std::atomic<int> next_shard{0};
+  std::atomic<int> result{0};
+  auto work = [&] (int worker) {
+    for (int i = next_shard++; i < num_shards; i = next_shard++) {
+      if (result < 0 || stop()) {
+        break;
+      }
+      int ret = process(worker, (i + start) % num_shards);
+      if (ret < 0) {
+        int expected = 0;
+        result.compare_exchange_strong(expected, ret);
+        break;
+      }
+    }
+    finish(worker);
+  };
+
+  if (!pool) {
+    num_workers = 1;
+  }
+  ceph::mutex lock = ceph::make_mutex("gc_walk_shards");
+  ceph::condition_variable cond;
+  int running = num_workers - 1;
+  for (int w = 1; w < num_workers; ++w) {
+    boost::asio::post(pool->get_executor(), [&, w] {
+      work(w);
+      std::lock_guard l{lock};
+      if (--running == 0) {
+        cond.notify_all();
+      }
+    });
+  }
+  work(0);
+  std::unique_lock l{lock};
+  cond.wait(l, [&] { return running == 0; });
+
+  return result;
+}
+
 int RGWGC::process(bool expired_only, optional_yield y)
 {
   int max_secs = cct->_conf->rgw_gc_processor_max_time;
 
   const int start = ceph::util::generate_random_number(0, max_objs - 1);
 
-  RGWGCIOManager io_manager(this, store->ctx(), this);
-
-  for (int i = 0; i < max_objs; i++) {
-    int index = (i + start) % max_objs;
-    int ret = process(index, max_secs, expired_only, io_manager, y);
-    if (ret < 0)
-      return ret;
+  // the shards are spread across the shard pool, each worker with its own
+  // io manager and its share of rgw_gc_max_concurrent_io; a coroutine
+  // caller, or one without a pool, processes them one at a time
+  int num_workers = 1;
+  ceph::async::io_context_pool* pool = nullptr;
+  if (!y && shard_pool) {
+    num_workers = std::min(shard_workers, max_objs);
+    pool = shard_pool.get();
   }
-  if (!going_down()) {
-    io_manager.drain();
+  const size_t max_aio = std::max<size_t>(
+    1, cct->_conf->rgw_gc_max_concurrent_io / num_workers);
+
+  std::vector<std::unique_ptr<RGWGCIOManager>> io_managers;
+  for (int w = 0; w < num_workers; ++w) {
+    io_managers.push_back(std::make_unique<RGWGCIOManager>(
+      this, store->ctx(), this, max_aio));
   }
 
-  return 0;
+  return gc_walk_shards(
+    pool, num_workers, max_objs, start,
+    [&] (int worker, int index) {
+      auto shard_start = ceph::mono_clock::now();
+      int ret = process(index, max_secs, expired_only,
+                        *io_managers[worker], y);
+      if (perfcounter) {
+        perfcounter->tinc(l_rgw_gc_shard_lat, ceph::mono_clock::now() - shard_start);
+      }
+      return ret;
+    },
+    [&] (int worker) {
+      if (!going_down()) {
+        io_managers[worker]->drain();
+      }
+    },
+    [this] { return going_down(); });
 }
 
 bool RGWGC::going_down()
@@ -683,6 +758,12 @@ bool RGWGC::going_down()
 
 void RGWGC::start_processor()
 {
+  shard_workers = std::clamp<int>(
+    cct->_conf.get_val<uint64_t>("rgw_gc_max_concurrent_shards"), 1, max_objs);
+  if (shard_workers > 1) {
+    shard_pool = std::make_unique<ceph::async::io_context_pool>(
+      shard_workers - 1);
+  }
   worker = new GCWorker(this, cct, this);
   worker->create("rgw_gc");
 }
@@ -696,6 +777,8 @@ void RGWGC::stop_processor()
   }
   delete worker;
   worker = NULL;
+  // the gc thread is gone, so nothing is running on the pool
+  shard_pool.reset();
 }
 
 unsigned RGWGC::get_subsys() const
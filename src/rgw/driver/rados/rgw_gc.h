@@ -14,9 +14,25 @@
 #include "cls/rgw/cls_rgw_types.h"
 
 #include <atomic>
+#include <functional>
+#include <memory>
+
+#include "common/async/context_pool.h"
 
 class RGWGCIOManager;
 
+/// Claims the shards [0, num_shards), beginning at start, from a shared
+/// cursor and calls process(worker, shard) for each of them. The calling
+/// thread is worker 0; workers 1..num_workers-1 run on pool, which may be
+/// null when num_workers is 1. A worker calls finish(worker) once no shards
+/// are left for it. No more shards are claimed after a call fails or once
+/// stop() returns true. Returns the first error.
+int gc_walk_shards(ceph::async::io_context_pool* pool, int num_workers,
+                   int num_shards, int start,
+                   const std::function<int(int, int)>& process,
+                   const std::function<void(int)>& finish,
+                   const std::function<bool()>& stop);
+
 class RGWGC : public DoutPrefixProvider {
   CephContext *cct;
   RGWRados *store;
@@ -43,13 +59,19 @@ class RGWGC : public DoutPrefixProvider {
   };
 
   GCWorker *worker;
+  /// extra threads for rgw_gc_max_concurrent_shards, started along with
+  /// the processor
+  std::unique_ptr<ceph::async::io_context_pool> shard_pool;
+  int shard_workers = 1;
 public:
   RGWGC() : cct(NULL), store(NULL), max_objs(0), obj_names(NULL), worker(NULL) {}
   ~RGWGC() {
     stop_processor();
     finalize();
   }
-  std::vector<bool> transitioned_objects_cache;
+  // shards are processed concurrently, so unlike vector<bool> each
+  // flag must be independently writable
+  std::unique_ptr<std::atomic<bool>[]> transitioned_objects_cache;
   int get_max_objs() const { return max_objs; }
   std::tuple<int, std::optional<cls_rgw_obj_chain>> send_split_chain(const cls_rgw_obj_chain& chain, const std::string& tag, optional_yield y);
 
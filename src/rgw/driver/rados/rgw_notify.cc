@@ -1103,11 +1103,63 @@ static inline std::string get_shard_name(const std::string& topic_name, const ui
   return (shard_id == 0) ? topic_name : fmt::format("{}.{}", topic_name, shard_id);
 }
 
+// reserve queue space for the persistent topics added to the reservation
+// starting at index 'first'. all events going to the same queue shard share
+// a single reservation, so a request matching several notifications costs
+// one round trip per shard instead of one per notification
+static int reserve_persistent_topics(reservation_t& res, size_t first) {
+  // TODO: take default reservation size from conf
+  constexpr auto DEFAULT_RESERVATION = 4 * 1024U;  // 4K
+  std::map<std::string, std::vector<reservation_t::topic_t*>> shards;
+  for (auto i = first; i < res.topics.size(); ++i) {
+    auto& topic = res.topics[i];
+    if (topic.cfg.dest.persistent) {
+      shards[get_shard_name(topic.cfg.dest.persistent_queue, topic.shard_id)].push_back(&topic);
+    }
+  }
+  if (shards.empty()) {
+    return 0;
+  }
+  // size is per event
+  res.size = DEFAULT_RESERVATION;
+  for (const auto& [shard_name, topics] : shards) {
+    ldpp_dout(res.dpp, 20) << "INFO: target_shard: " << shard_name
+      << " reserving: " << topics.size() << " entries" << dendl;
+    librados::ObjectWriteOperation op;
+    bufferlist obl;
+    int rval;
+    cls_2pc_queue_reserve(op, res.size * topics.size(), topics.size(), &obl, &rval);
+    auto ret = rgw_rados_operate(
+        res.dpp, res.store->getRados()->get_notif_pool_ctx(), shard_name,
+        std::move(op), res.yield, librados::OPERATION_RETURNVEC);
+    if (ret < 0) {
+      ldpp_dout(res.dpp, 1)
+          << "ERROR: failed to reserve notification on queue: "
+          << shard_name << ". error: " << ret << dendl;
+      // if no space is left in queue we ask client to slow down
+      return (ret == -ENOSPC) ? -ERR_RATE_LIMITED : ret;
+    }
+    cls_2pc_reservation::id_t res_id = cls_2pc_reservation::NO_ID;
+    ret = cls_2pc_queue_reserve_result(obl, res_id);
+    if (ret < 0) {
+      ldpp_dout(res.dpp, 1)
+          << "ERROR: failed to parse reservation id. error: " << ret
+          << dendl;
+      return ret;
+    }
+    for (auto topic : topics) {
+      topic->res_id = res_id;
+    }
+  }
+  return 0;
+}
+
 int publish_reserve(const DoutPrefixProvider* dpp,
                     const SiteConfig& site,
                     const EventTypeList& event_types,
                     reservation_t& res,
                     const RGWObjTags* req_tags) {
+  const auto first_topic = res.topics.size();
   rgw_pubsub_bucket_topics bucket_topics;
   if (all_zonegroups_support(site, zone_features::notification_v2) &&
       res.store->stat_topics_v1(res.user_tenant, res.yield, res.dpp) == -ENOENT) {
@@ -1163,46 +1215,21 @@ int publish_reserve(const DoutPrefixProvider* dpp,
             << dendl;
       }
 
-      cls_2pc_reservation::id_t res_id = cls_2pc_reservation::NO_ID;
       uint64_t target_shard = 0; 
       if (topic_cfg.dest.persistent) {
-        // TODO: take default reservation size from conf
-        constexpr auto DEFAULT_RESERVATION = 4 * 1024U;  // 4K
-        res.size = DEFAULT_RESERVATION;
-        librados::ObjectWriteOperation op;
-        bufferlist obl;
-        int rval;
         const std::string bucket_name = res.bucket->get_name(); 
         const std::string object_key = res.object_name ? *res.object_name : res.object->get_name();
         const uint64_t num_shards = topic_cfg.dest.num_shards; 
         target_shard = get_target_shard(
             dpp, bucket_name, object_key, num_shards); 
-        const auto shard_name = get_shard_name(topic_cfg.dest.persistent_queue, target_shard);
-        ldpp_dout(res.dpp, 1) << "INFO: target_shard: " << shard_name << dendl;       
-        cls_2pc_queue_reserve(op, res.size, 1, &obl, &rval);
-        auto ret = rgw_rados_operate(
-            res.dpp, res.store->getRados()->get_notif_pool_ctx(), shard_name,
-            std::move(op), res.yield, librados::OPERATION_RETURNVEC);
-        if (ret < 0) {
-          ldpp_dout(res.dpp, 1)
-              << "ERROR: failed to reserve notification on queue: "
-              << shard_name << ". error: " << ret << dendl;
-          // if no space is left in queue we ask client to slow down
-          return (ret == -ENOSPC) ? -ERR_RATE_LIMITED : ret;
-        }
-        ret = cls_2pc_queue_reserve_result(obl, res_id);
-        if (ret < 0) {
-          ldpp_dout(res.dpp, 1)
-              << "ERROR: failed to parse reservation id. error: " << ret
-              << dendl;
-          return ret;
-        }
       }
 
-      res.topics.emplace_back(topic_filter.s3_id, topic_cfg, res_id, event_type, target_shard);
+      // queue space for persistent topics is reserved below
+      res.topics.emplace_back(topic_filter.s3_id, topic_cfg,
+                              cls_2pc_reservation::NO_ID, event_type, target_shard);
     }
   }
-  return 0;
+  return reserve_persistent_topics(res, first_topic);
 }
 
 int publish_commit(rgw::sal::Object* obj,
@@ -1213,10 +1240,19 @@ int publish_commit(rgw::sal::Object* obj,
 		   reservation_t& res,
 		   const DoutPrefixProvider* dpp)
 {
+  // persistent events sharing a reservation are committed in a single op
+  struct pending_commit {
+    std::string shard_name;
+    cls_2pc_reservation::id_t res_id;
+    std::vector<buffer::list> bl_data_vec;
+    uint64_t size = 0;
+    std::vector<reservation_t::topic_t*> topics;
+  };
+  std::vector<pending_commit> commits;
   for (auto& topic : res.topics) {
-    if (topic.cfg.dest.persistent &&
+    if (!topic.cfg.dest.persistent ||
 	topic.res_id == cls_2pc_reservation::NO_ID) {
-      // nothing to commit or already committed/aborted
+      // sync notification, nothing to commit or already committed/aborted
       continue;
     }
     event_entry_t event_entry;
@@ -1224,102 +1260,133 @@ int publish_commit(rgw::sal::Object* obj,
                    event_entry.event);
     event_entry.event.configurationId = topic.configurationId;
     event_entry.event.opaque_data = topic.cfg.opaque_data;
-    if (topic.cfg.dest.persistent) { 
-      event_entry.push_endpoint = std::move(topic.cfg.dest.push_endpoint);
-      event_entry.push_endpoint_args =
-	std::move(topic.cfg.dest.push_endpoint_args);
-      event_entry.arn_topic = topic.cfg.dest.arn_topic;
-      event_entry.creation_time = ceph::coarse_real_clock::now();
-      event_entry.time_to_live = topic.cfg.dest.time_to_live;
-      event_entry.max_retries = topic.cfg.dest.max_retries;
-      event_entry.retry_sleep_duration = topic.cfg.dest.retry_sleep_duration;
-      bufferlist bl;
-      encode(event_entry, bl);
-      uint64_t target_shard = topic.shard_id;
-      const auto shard_name = get_shard_name(topic.cfg.dest.persistent_queue, target_shard);  
-      ldpp_dout(res.dpp, 1) << "INFO: target_shard: " << shard_name << dendl;   
-      if (bl.length() > res.size) {
-        // try to make a larger reservation, fail only if this is not possible
-        ldpp_dout(dpp, 5) << "WARNING: committed size: " << bl.length()
-			  << " exceeded reserved size: " << res.size
-			  <<
-          " . trying to make a larger reservation on queue:" << shard_name
-			  << dendl;
-        // first cancel the existing reservation
-        librados::ObjectWriteOperation op;
-        cls_2pc_queue_abort(op, topic.res_id);
-        auto ret = rgw_rados_operate(
-	  dpp, res.store->getRados()->get_notif_pool_ctx(),
-	  shard_name, std::move(op),
-	  res.yield);
-        if (ret < 0) {
-          ldpp_dout(dpp, 1) << "ERROR: failed to abort reservation: "
-			    << topic.res_id << 
-            " when trying to make a larger reservation on queue: " << shard_name
-			    << ". error: " << ret << dendl;
-          return ret;
-        }
-        // now try to make a bigger one
-	buffer::list obl;
-        int rval;
-        op = librados::ObjectWriteOperation();
-        cls_2pc_queue_reserve(op, bl.length(), 1, &obl, &rval);
-        ret = rgw_rados_operate(
-	  dpp, res.store->getRados()->get_notif_pool_ctx(),
-          shard_name, std::move(op), res.yield, librados::OPERATION_RETURNVEC);
-        if (ret < 0) {
-          ldpp_dout(dpp, 1) << "ERROR: failed to reserve extra space on queue: "
-			    << shard_name
-			    << ". error: " << ret << dendl;
-          return (ret == -ENOSPC) ? -ERR_RATE_LIMITED : ret;
-        }
-        ret = cls_2pc_queue_reserve_result(obl, topic.res_id);
-        if (ret < 0) {
-          ldpp_dout(dpp, 1) << "ERROR: failed to parse reservation id for "
-	    "extra space. error: " << ret << dendl;
-          return ret;
-        }
-      }
-      std::vector<buffer::list> bl_data_vec{std::move(bl)};
+    event_entry.push_endpoint = topic.cfg.dest.push_endpoint;
+    event_entry.push_endpoint_args = topic.cfg.dest.push_endpoint_args;
+    event_entry.arn_topic = topic.cfg.dest.arn_topic;
+    event_entry.creation_time = ceph::coarse_real_clock::now();
+    event_entry.time_to_live = topic.cfg.dest.time_to_live;
+    event_entry.max_retries = topic.cfg.dest.max_retries;
+    event_entry.retry_sleep_duration = topic.cfg.dest.retry_sleep_duration;
+    bufferlist bl;
+    encode(event_entry, bl);
+    auto shard_name = get_shard_name(topic.cfg.dest.persistent_queue, topic.shard_id);
+    auto it = std::find_if(commits.begin(), commits.end(),
+        [&] (const pending_commit& c) {
+          return c.res_id == topic.res_id && c.shard_name == shard_name;
+        });
+    if (it == commits.end()) {
+      it = commits.emplace(commits.end());
+      it->shard_name = std::move(shard_name);
+      it->res_id = topic.res_id;
+    }
+    it->size += bl.length();
+    it->bl_data_vec.push_back(std::move(bl));
+    it->topics.push_back(&topic);
+  }
+
+  for (auto& commit : commits) {
+    const auto& shard_name = commit.shard_name;
+    ldpp_dout(res.dpp, 20) << "INFO: target_shard: " << shard_name
+      << " committing: " << commit.bl_data_vec.size() << " entries" << dendl;
+    const uint64_t reserved_size = res.size * commit.topics.size();
+    if (commit.size > reserved_size) {
+      // try to make a larger reservation, fail only if this is not possible
+      ldpp_dout(dpp, 5) << "WARNING: committed size: " << commit.size
+			<< " exceeded reserved size: " << reserved_size
+			<<
+        " . trying to make a larger reservation on queue:" << shard_name
+			<< dendl;
+      // first cancel the existing reservation
       librados::ObjectWriteOperation op;
-      cls_2pc_queue_commit(op, bl_data_vec, topic.res_id);
-      topic.res_id = cls_2pc_reservation::NO_ID;
-      auto pcc_arg = make_unique<PublishCommitCompleteArg>(shard_name, dpp->get_cct());
-      aio_completion_ptr completion{librados::Rados::aio_create_completion(pcc_arg.get(), publish_commit_completion)};
-      auto& io_ctx = res.store->getRados()->get_notif_pool_ctx();
-      if (const int ret = io_ctx.aio_operate(shard_name, completion.get(), &op); ret < 0) {
-        ldpp_dout(dpp, 1) << "ERROR: failed to commit reservation to queue: "
-                          << shard_name << ". error: " << ret << dendl;
+      cls_2pc_queue_abort(op, commit.res_id);
+      auto ret = rgw_rados_operate(
+	dpp, res.store->getRados()->get_notif_pool_ctx(),
+	shard_name, std::move(op),
+	res.yield);
+      if (ret < 0) {
+        ldpp_dout(dpp, 1) << "ERROR: failed to abort reservation: "
+			  << commit.res_id << 
+          " when trying to make a larger reservation on queue: " << shard_name
+			  << ". error: " << ret << dendl;
         return ret;
       }
-      // args will be released inside the callback
-      pcc_arg.release();
-    } else {
-      try {
-        // TODO add endpoint LRU cache
-        const auto push_endpoint = RGWPubSubEndpoint::create(
+      for (auto topic : commit.topics) {
+        topic->res_id = cls_2pc_reservation::NO_ID;
+      }
+      // now try to make a bigger one
+      buffer::list obl;
+      int rval;
+      op = librados::ObjectWriteOperation();
+      cls_2pc_queue_reserve(op, commit.size, commit.bl_data_vec.size(), &obl, &rval);
+      ret = rgw_rados_operate(
+	dpp, res.store->getRados()->get_notif_pool_ctx(),
+        shard_name, std::move(op), res.yield, librados::OPERATION_RETURNVEC);
+      if (ret < 0) {
+        ldpp_dout(dpp, 1) << "ERROR: failed to reserve extra space on queue: "
+			  << shard_name
+			  << ". error: " << ret << dendl;
+        return (ret == -ENOSPC) ? -ERR_RATE_LIMITED : ret;
+      }
+      ret = cls_2pc_queue_reserve_result(obl, commit.res_id);
+      if (ret < 0) {
+        ldpp_dout(dpp, 1) << "ERROR: failed to parse reservation id for "
+	  "extra space. error: " << ret << dendl;
+        return ret;
+      }
+      for (auto topic : commit.topics) {
+        topic->res_id = commit.res_id;
+      }
+    }
+    librados::ObjectWriteOperation op;
+    cls_2pc_queue_commit(op, commit.bl_data_vec, commit.res_id);
+    for (auto topic : commit.topics) {
+      topic->res_id = cls_2pc_reservation::NO_ID;
+    }
+    auto pcc_arg = make_unique<PublishCommitCompleteArg>(shard_name, dpp->get_cct());
+    aio_completion_ptr completion{librados::Rados::aio_create_completion(pcc_arg.get(), publish_commit_completion)};
+    auto& io_ctx = res.store->getRados()->get_notif_pool_ctx();
+    if (const int ret = io_ctx.aio_operate(shard_name, completion.get(), &op); ret < 0) {
+      ldpp_dout(dpp, 1) << "ERROR: failed to commit reservation to queue: "
+                        << shard_name << ". error: " << ret << dendl;
+      return ret;
+    }
+    // args will be released inside the callback
+    pcc_arg.release();
+  }
+
+  for (auto& topic : res.topics) {
+    if (topic.cfg.dest.persistent) {
+      continue;
+    }
+    event_entry_t event_entry;
+    populate_event(res, obj, size, mtime, etag, version, topic.event_type,
+                   event_entry.event);
+    event_entry.event.configurationId = topic.configurationId;
+    event_entry.event.opaque_data = topic.cfg.opaque_data;
+    try {
+      // TODO add endpoint LRU cache
+      const auto push_endpoint = RGWPubSubEndpoint::create(
 	  topic.cfg.dest.push_endpoint,
 	  topic.cfg.dest.arn_topic,
 	  RGWHTTPArgs(topic.cfg.dest.push_endpoint_args, dpp),
 	  dpp->get_cct());
-        ldpp_dout(res.dpp, 20) << "INFO: push endpoint created: "
+      ldpp_dout(res.dpp, 20) << "INFO: push endpoint created: "
 			       << topic.cfg.dest.push_endpoint << dendl;
-        const auto ret = push_endpoint->send(dpp, event_entry.event, res.yield);
-        if (ret < 0) {
-          ldpp_dout(dpp, 1)
-              << "ERROR: failed to push sync notification event with error: "
-              << ret << " for event with " << event_entry << dendl;
-          if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_failed);
-          return ret;
-        }
-        if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_ok);
-      } catch (const RGWPubSubEndpoint::configuration_error& e) {
-        ldpp_dout(dpp, 1) << "ERROR: failed to create push endpoint for sync "
-                             "notification event  with  error: "
-                          << e.what() << " event with " << event_entry << dendl;
+      const auto ret = push_endpoint->send(dpp, event_entry.event, res.yield);
+      if (ret < 0) {
+        ldpp_dout(dpp, 1)
+            << "ERROR: failed to push sync notification event with error: "
+            << ret << " for event with " << event_entry << dendl;
         if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_failed);
-        return -EINVAL;
+        return ret;
       }
+      if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_ok);
+    } catch (const RGWPubSubEndpoint::configuration_error& e) {
+      ldpp_dout(dpp, 1) << "ERROR: failed to create push endpoint for sync "
+                           "notification event  with  error: "
+                        << e.what() << " event with " << event_entry << dendl;
+      if (perfcounter) perfcounter->inc(l_rgw_pubsub_push_failed);
+      return -EINVAL;
     }
   }
   return 0;
@@ -1334,19 +1401,26 @@ int publish_abort(reservation_t& res) {
     }
     uint64_t target_shard = topic.shard_id;   
     const auto shard_name = get_shard_name(topic.cfg.dest.persistent_queue, target_shard);   
-    ldpp_dout(res.dpp, 1) << "INFO: target_shard: " << shard_name << dendl;
+    ldpp_dout(res.dpp, 20) << "INFO: target_shard: " << shard_name << dendl;
+    const auto res_id = topic.res_id;
     librados::ObjectWriteOperation op;
-    cls_2pc_queue_abort(op, topic.res_id);
+    cls_2pc_queue_abort(op, res_id);
     const auto ret = rgw_rados_operate(
       res.dpp, res.store->getRados()->get_notif_pool_ctx(),
       shard_name, std::move(op), res.yield);
     if (ret < 0) {
       ldpp_dout(res.dpp, 1) << "ERROR: failed to abort reservation: "
-			    << topic.res_id <<
+			    << res_id <<
         " from queue: " << shard_name << ". error: " << ret << dendl;
       return ret;
     }
-    topic.res_id = cls_2pc_reservation::NO_ID;
+    // the reservation may be shared by other topics on the same queue shard
+    for (auto& t : res.topics) {
+      if (t.cfg.dest.persistent && t.res_id == res_id &&
+          get_shard_name(t.cfg.dest.persistent_queue, t.shard_id) == shard_name) {
+        t.res_id = cls_2pc_reservation::NO_ID;
+      }
+    }
   }
   return 0;
 }
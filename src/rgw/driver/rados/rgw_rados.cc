@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sstream>
+#include <queue>
 
 #include <boost/algorithm/string.hpp>
 #include <string_view>
@@ -8455,7 +8456,10 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
 
     bl_list.push_back(bl);
     offset += bl.length();
+    const auto start = ceph::mono_clock::now();
     int r = client_cb->handle_data(bl, 0, bl.length());
+    client_wait += ceph::mono_clock::now() - start;
+    window_bytes += bl.length();
     if (r < 0) {
       return r;
     }
@@ -8475,6 +8479,30 @@ int get_obj_data::flush(rgw::AioResultList&& results) {
   return 0;
 }
 
+void get_obj_data::adapt_window(const DoutPrefixProvider *dpp)
+{
+  if (max_window <= min_window || window_bytes < window) {
+    return; // fixed window, or the sample isn't complete yet
+  }
+  const uint64_t old_window = window;
+  if (read_wait > client_wait) {
+    // the client drains faster than rados fills the window; keep more
+    // reads in flight to cover the read latency
+    window = std::min(window * 2, max_window);
+  } else if (read_wait * 4 < client_wait) {
+    // bound by the client; don't hold more data than it can take
+    window = std::max(window / 2, min_window);
+  }
+  if (window != old_window) {
+    ldpp_dout(dpp, 20) << "get_obj_data: read window " << old_window
+        << " -> " << window << " (read_wait=" << read_wait
+        << " client_wait=" << client_wait << ")" << dendl;
+    aio->set_window(window);
+  }
+  window_bytes = 0;
+  read_wait = client_wait = ceph::timespan::zero();
+}
+
 static int _get_obj_iterate_cb(const DoutPrefixProvider *dpp,
                                const rgw_raw_obj& read_obj, off_t obj_ofs,
                                off_t read_ofs, off_t len, bool is_head_obj,
@@ -8533,9 +8561,16 @@ int RGWRados::get_obj_iterate_cb(const DoutPrefixProvider *dpp,
   const uint64_t cost = len;
   const uint64_t id = obj_ofs; // use logical object offset for sorting replies
 
+  const auto start = ceph::mono_clock::now();
   auto completed = d->aio->get(obj.obj, rgw::Aio::librados_op(obj.ioctx, std::move(op), d->yield), cost, id);
+  d->read_wait += ceph::mono_clock::now() - start;
 
-  return d->flush(std::move(completed));
+  r = d->flush(std::move(completed));
+  if (r < 0) {
+    return r;
+  }
+  d->adapt_window(dpp);
+  return 0;
 }
 
 int RGWRados::Object::Read::iterate(const DoutPrefixProvider *dpp, int64_t ofs, int64_t end, RGWGetDataCB *cb,
@@ -8545,9 +8580,12 @@ int RGWRados::Object::Read::iterate(const DoutPrefixProvider *dpp, int64_t ofs,
   CephContext *cct = store->ctx();
   const uint64_t chunk_size = cct->_conf->rgw_get_obj_max_req_size;
   const uint64_t window_size = cct->_conf->rgw_get_obj_window_size;
+  const uint64_t max_window_size =
+    cct->_conf.get_val<Option::size_t>("rgw_get_obj_max_window_size");
 
   auto aio = rgw::make_throttle(window_size, y);
   get_obj_data data(store, cb, &*aio, ofs, y);
+  data.init_window(window_size, max_window_size);
 
   if (state.obj.empty()) {
     state.obj = source->get_obj();
@@ -10911,18 +10949,33 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     const std::string& oid_name;
     RGWRados::ent_map_t::iterator cursor;
     RGWRados::ent_map_t::iterator end;
+    // where a follow-up read of this shard resumes; captured before
+    // the entries are moved into the caller's map
+    cls_rgw_obj_key resume_key;
+    uint32_t read_size;
+    uint32_t refills = 0;
 
     // manages an iterator through a shard and provides other
     // accessors
     ShardTracker(size_t _shard_idx,
 		 rgw_cls_list_ret& _result,
-		 const std::string& _oid_name):
+		 const std::string& _oid_name,
+		 const cls_rgw_obj_key& start_after,
+		 uint32_t _read_size):
       shard_idx(_shard_idx),
       result(_result),
       oid_name(_oid_name),
-      cursor(_result.dir.m.begin()),
-      end(_result.dir.m.end())
-    {}
+      resume_key(start_after),
+      read_size(_read_size)
+    {
+      reset();
+    }
+
+    void reset() {
+      cursor = result.dir.m.begin();
+      end = result.dir.m.end();
+      resume_key = cls_rgw_bucket_list_resume_key(result, resume_key);
+    }
 
     inline const std::string& entry_name() const {
       return cursor->first;
@@ -10944,21 +10997,12 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     }
   }; // ShardTracker
 
-  // add the next unique candidate, or return false if we reach the end
-  auto next_candidate = [] (CephContext *cct, ShardTracker& t,
-                            std::multimap<std::string, size_t>& candidates,
-                            size_t tracker_idx) {
-    if (!t.at_end()) {
-      candidates.emplace(t.entry_name(), tracker_idx);
-    }
-    return;
-  };
-
   // one tracker per shard requested (may not be all shards)
   std::vector<ShardTracker> results_trackers;
   results_trackers.reserve(shard_list_results.size());
   for (auto& r : shard_list_results) {
-    results_trackers.emplace_back(r.first, r.second, shard_oids[r.first]);
+    results_trackers.emplace_back(r.first, r.second, shard_oids[r.first],
+				  start_after_key, num_entries_per_shard);
 
     // if any *one* shard's result is truncated, the entire result is
     // truncated
@@ -10969,35 +11013,69 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     *cls_filtered = *cls_filtered && r.second.cls_filtered;
   }
 
-  // create a map to track the next candidate entry from ShardTracker
-  // (key=candidate, value=index into results_trackers); as we consume
-  // entries from shards, we replace them with the next entries in the
-  // shards until we run out
-  std::multimap<std::string, size_t> candidates;
-  size_t tracker_idx = 0;
-  std::vector<size_t> vidx;
-  vidx.reserve(shard_list_results.size());
-  for (auto& t : results_trackers) {
-    // it's important that the values in the map refer to the index
+  // a shard that runs dry while still truncated is read again on its
+  // own, so only the shards actually contributing entries are asked
+  // for more; each refill doubles that shard's read size
+  const uint32_t max_refills = cct->_conf->rgw_bucket_list_max_shard_refills;
+  auto refill = [&](ShardTracker& t) -> int {
+    t.read_size = std::min(num_entries, t.read_size * 2);
+    ++t.refills;
+
+    const cls_rgw_obj_key start_after = t.resume_key;
+    std::map<int, std::string> oid{{int(t.shard_idx), t.oid_name}};
+    std::map<int, rgw_cls_list_ret> results;
+    int r = svc.bi_rados->list_objects(dpp, y, ioctx, oid, start_after,
+				       prefix, delimiter, t.read_size,
+				       list_versions, results);
+    if (r < 0) {
+      ldpp_dout(dpp, 0) << __func__ <<
+	": refilling shard " << t.shard_idx << " of " <<
+	bucket_info.bucket << " failed: " << cpp_strerror(-r) << dendl;
+      return r;
+    }
+    t.result = std::move(results[t.shard_idx]);
+    t.reset();
+    *cls_filtered = *cls_filtered && t.result.cls_filtered;
+
+    ldpp_dout(dpp, 20) << __func__ << ": refilled shard " << t.shard_idx <<
+      " with " << t.result.dir.m.size() << " entries after " <<
+      start_after << ", is_truncated=" << t.is_truncated() << dendl;
+    return 0;
+  };
+
+  // min-heap of the next candidate entry from each ShardTracker
+  // (first=candidate, second=index into results_trackers); as we
+  // consume entries from shards, we replace them with the next entries
+  // in the shards until we run out
+  using Candidate = std::pair<std::string, size_t>;
+  std::priority_queue<Candidate, std::vector<Candidate>,
+		      std::greater<Candidate>> candidates;
+  for (size_t tracker_idx = 0; tracker_idx < results_trackers.size();
+       ++tracker_idx) {
+    // it's important that the values in the heap refer to the index
     // into the results_trackers vector, which may not be the same
     // as the shard number (i.e., when not all shards are requested)
-    next_candidate(cct, t, candidates, tracker_idx);
-    ++tracker_idx;
+    auto& t = results_trackers[tracker_idx];
+    if (!t.at_end()) {
+      candidates.emplace(t.entry_name(), tracker_idx);
+    }
   }
 
-  rgw_bucket_dir_entry*
-    last_entry_visited = nullptr; // to set last_entry (marker)
+  // to set last_entry (marker); a copy, since a refill replaces the
+  // shard results a skipped entry lives in
+  std::optional<cls_rgw_obj_key> last_key_visited;
   std::map<std::string, bufferlist> updates;
   uint32_t count = 0;
+  std::vector<size_t> vidx;
+  vidx.reserve(results_trackers.size());
   while (count < num_entries && !candidates.empty()) {
     r = 0;
-    // select the next entry in lexical order (first key in map);
-    // again tracker_idx is not necessarily shard number, but is index
-    // into results_trackers vector
-    tracker_idx = candidates.begin()->second;
-    auto& tracker = results_trackers.at(tracker_idx);
+    // select the next entry in lexical order (top of the heap); again
+    // tracker_idx is not necessarily shard number, but is index into
+    // results_trackers vector
+    const std::string name = candidates.top().first;
+    auto& tracker = results_trackers.at(candidates.top().second);
 
-    const std::string& name = tracker.entry_name();
     rgw_bucket_dir_entry& dirent = tracker.dir_entry();
 
     ldpp_dout(dpp, 20) << __func__ << ": currently processing " <<
@@ -11037,7 +11115,7 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 	dirent_key << dendl;
 
       auto [it, inserted] = m.insert_or_assign(name, std::move(dirent));
-      last_entry_visited = &it->second;
+      last_key_visited = dirent_key;
       if (inserted) {
 	++count;
       } else {
@@ -11048,22 +11126,30 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     } else {
       ldpp_dout(dpp, 10) << __func__ << ": skipping " <<
 	dirent.key.name << "[" << dirent.key.instance << "]" << dendl;
-      last_entry_visited = &tracker.dir_entry();
+      last_key_visited = dirent_key;
     }
 
-    // refresh the candidates map
+    // refresh the candidates heap; every shard holding this name
+    // (e.g., the same common prefix) moves past it
     vidx.clear();
+    while (!candidates.empty() && candidates.top().first == name) {
+      vidx.push_back(candidates.top().second);
+      candidates.pop();
+    }
     bool need_to_stop = false;
-    auto range = candidates.equal_range(name);
-    for (auto i = range.first; i != range.second; ++i) {
-      vidx.push_back(i->second);
-    } 
-    candidates.erase(range.first, range.second);
     for (auto idx : vidx) {
       auto& tracker_match = results_trackers.at(idx);
       tracker_match.advance();
-      next_candidate(cct, tracker_match, candidates, idx);
-      if (tracker_match.at_end() && tracker_match.is_truncated()) {
+      while (tracker_match.at_end() && tracker_match.is_truncated() &&
+	     tracker_match.refills < max_refills) {
+	r = refill(tracker_match);
+	if (r < 0) {
+	  return r;
+	}
+      }
+      if (!tracker_match.at_end()) {
+	candidates.emplace(tracker_match.entry_name(), idx);
+      } else if (tracker_match.is_truncated()) {
         need_to_stop = true;
         break;
       }
@@ -11119,8 +11205,8 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
       count << ", which is truncated" << dendl;
   }
 
-  if (last_entry_visited != nullptr && last_entry) {
-    *last_entry = last_entry_visited->key;
+  if (last_key_visited && last_entry) {
+    *last_entry = *last_key_visited;
     ldpp_dout(dpp, 20) << __func__ <<
       ": returning, last_entry=" << *last_entry << dendl;
   } else {
@@ -1779,6 +1779,22 @@ struct get_obj_data {
   D3nGetObjData d3n_get_data;
   std::atomic_bool d3n_bypass_cache_write{false};
 
+  // adaptive read window. it starts at rgw_get_obj_window_size and is
+  // resized after every window's worth of data sent to the client,
+  // growing while we wait on rados reads rather than on the client
+  uint64_t window = 0;
+  uint64_t min_window = 0;
+  uint64_t max_window = 0;
+  uint64_t window_bytes = 0; // sent to the client in this sample
+  ceph::timespan read_wait = ceph::timespan::zero(); // blocked on the throttle
+  ceph::timespan client_wait = ceph::timespan::zero(); // in handle_data()
+
+  void init_window(uint64_t base, uint64_t max) {
+    window = min_window = base;
+    max_window = std::max(base, max);
+  }
+  void adapt_window(const DoutPrefixProvider *dpp);
+
   int flush(rgw::AioResultList&& results);
 
   void cancel() {
@@ -1171,6 +1171,15 @@ int RGWBucketReshard::reshard_process(const rgw::bucket_index_layout_generation&
         }
       } // entries loop
     }
+
+    if (reshard_stage == rgw::BucketReshardState::InLogrecord &&
+        bucket_info.layout.resharding == rgw::BucketReshardState::InLogrecord) {
+      int ret = catchup_shard_log(current, i, max_op_entries,
+                                  target_shards_mgr, dpp, y);
+      if (ret < 0) {
+        return ret;
+      }
+    }
   }
 
   if (verbose_json_out) {
@@ -1190,6 +1199,109 @@ int RGWBucketReshard::reshard_process(const rgw::bucket_index_layout_generation&
   return 0;
 }
 
+int RGWBucketReshard::catchup_shard_log(const rgw::bucket_index_layout_generation& current,
+                                        int shard_id, int max_op_entries,
+                                        BucketReshardManager& target_shards_mgr,
+                                        const DoutPrefixProvider *dpp, optional_yield y)
+{
+  const uint64_t max_passes =
+    store->ctx()->_conf.get_val<uint64_t>("rgw_reshard_log_catchup_passes");
+  if (max_passes == 0) {
+    return 0;
+  }
+
+  // the inventory copied so far must land before any log entries that
+  // supersede it
+  int ret = target_shards_mgr.finish(false, this, dpp);
+  if (ret < 0) {
+    return ret;
+  }
+
+  RGWRados::BucketShard bs(store->getRados());
+  ret = bs.init(dpp, bucket_info, current, shard_id, y);
+  if (ret < 0) {
+    ldpp_dout(dpp, 0) << "ERROR: " << __func__ << " failed to init source shard "
+        << shard_id << ": " << cpp_strerror(-ret) << dendl;
+    return ret;
+  }
+
+  const std::string null_object_filter;
+  const bool process_log = true;
+  for (uint64_t pass = 0; pass < max_passes; ++pass) {
+    uint64_t replayed = 0;
+    string marker;
+    bool is_truncated = true;
+    while (is_truncated) {
+      list<rgw_cls_bi_entry> entries;
+      ret = store->getRados()->bi_list(dpp, bucket_info, shard_id, null_object_filter,
+                                       marker, max_op_entries, &entries,
+                                       &is_truncated, process_log, y);
+      if (ret == -ENOENT) {
+        return 0;
+      } else if (ret < 0) {
+        ldpp_dout(dpp, 0) << "ERROR: " << __func__ << " bi_list(): "
+            << cpp_strerror(-ret) << dendl;
+        return ret;
+      }
+      if (entries.empty()) {
+        break;
+      }
+      marker = entries.back().idx;
+
+      for (auto& entry : entries) {
+        cls_rgw_obj_key cls_key;
+        RGWObjCategory category;
+        rgw_bucket_category_stats stats;
+        bool account = entry.get_info(&cls_key, &category, &stats);
+        rgw_obj_key key(cls_key);
+        if (entry.type == BIIndexType::OLH && key.empty()) {
+          continue;
+        }
+        int shard_index;
+        ret = calc_target_shard(bucket_info, key, shard_index, dpp);
+        if (ret < 0) {
+          return ret;
+        }
+        ret = target_shards_mgr.add_entry(shard_index, entry, account,
+                                          category, stats, process_log);
+        if (ret < 0) {
+          return ret;
+        }
+      }
+
+      // the batch must be applied to the target shards before its log
+      // records can go
+      ret = target_shards_mgr.finish(process_log, this, dpp);
+      if (ret < 0) {
+        return ret;
+      }
+
+      librados::ObjectWriteOperation op;
+      cls_rgw_bucket_reshard_log_trim_entries(op, {entries.begin(), entries.end()});
+      ret = bs.bucket_obj.operate(dpp, std::move(op), y);
+      if (ret == -EOPNOTSUPP) {
+        // osds without reshard_log_trim_entries; the InProgress stage will
+        // replay the whole log instead
+        ldpp_dout(dpp, 5) << __func__ << ": reshard log catch-up not supported"
+            " by the osd, skipping" << dendl;
+        return 0;
+      } else if (ret < 0) {
+        ldpp_dout(dpp, 0) << "ERROR: " << __func__ << " failed to trim reshard log of shard "
+            << shard_id << ": " << cpp_strerror(-ret) << dendl;
+        return ret;
+      }
+      replayed += entries.size();
+    }
+
+    ldpp_dout(dpp, 20) << __func__ << ": shard " << shard_id << " pass " << pass
+        << " replayed " << replayed << " log entries" << dendl;
+    if (replayed < static_cast<uint64_t>(max_op_entries)) {
+      break; // caught up; the rest waits for the InProgress stage
+    }
+  }
+  return 0;
+}
+
 int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& current,
                                  const rgw::bucket_index_layout_generation& target,
                                  int max_op_entries, // max num to process per op
@@ -94,6 +94,12 @@ class RGWBucketReshard {
                       std::ostream *out,
                       Formatter *formatter, rgw::BucketReshardState reshard_stage,
                       const DoutPrefixProvider *dpp, optional_yield y);
+  // replay and trim the reshard log of one source shard while client writes
+  // are still allowed, so the blocking InProgress stage has little left
+  int catchup_shard_log(const rgw::bucket_index_layout_generation& current,
+                        int shard_id, int max_op_entries,
+                        BucketReshardManager& target_shards_mgr,
+                        const DoutPrefixProvider *dpp, optional_yield y);
 
   int do_reshard(const rgw::bucket_index_layout_generation& current,
                  const rgw::bucket_index_layout_generation& target,
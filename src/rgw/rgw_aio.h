@@ -98,6 +98,11 @@ class Aio {
   // wait for all outstanding completions and return their results
   virtual AioResultList drain() = 0;
 
+  // resize the window of outstanding operations, for implementations
+  // that have one. must be called from the thread (or strand) issuing
+  // operations
+  virtual void set_window(uint64_t window) {}
+
   static OpFunc librados_op(librados::IoCtx ctx,
                             librados::ObjectReadOperation&& op,
                             optional_yield y);
@@ -7,12 +7,16 @@
 #include <iomanip>
 #include <list>
 #include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/cancellation_signal.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/v6_only.hpp>
@@ -27,7 +31,9 @@
 
 #include "common/async/shared_mutex.h"
 #include "common/errno.h"
+#include "common/numa.h"
 #include "common/strtol.h"
+#include "common/Thread.h"
 
 #include "rgw_asio_client.h"
 #include "rgw_asio_frontend.h"
@@ -486,7 +492,26 @@ class AsioFrontend {
   SharedMutex pause_mutex;
   std::unique_ptr<rgw::dmclock::Scheduler> scheduler;
 
+  // with io_shards configured, each shard runs a private io_context on its
+  // own (optionally cpu-pinned) threads and accepts connections on its own
+  // SO_REUSEPORT listeners. connections are handled on the shard that
+  // accepted them for their whole lifetime
+  struct IoShard {
+    boost::asio::io_context context;
+    std::optional<boost::asio::executor_work_guard<
+        boost::asio::io_context::executor_type>> work;
+    std::vector<std::thread> threads;
+    std::vector<int> cpus; // empty unless pinned
+
+    explicit IoShard(int concurrency)
+      : context(concurrency), work(context.get_executor()) {}
+  };
+  // declared before the listeners that hold their io_contexts
+  std::vector<std::unique_ptr<IoShard>> shards;
+  unsigned threads_per_shard = 1;
+
   struct Listener {
+    boost::asio::io_context& context;
     tcp::endpoint endpoint;
     tcp::acceptor acceptor;
     tcp::socket socket;
@@ -495,7 +520,7 @@ class AsioFrontend {
     bool use_nodelay = false;
 
     explicit Listener(boost::asio::io_context& context)
-      : acceptor(context), socket(context) {}
+      : context(context), acceptor(context), socket(context) {}
   };
   std::list<Listener> listeners;
 
@@ -511,6 +536,10 @@ class AsioFrontend {
   void accept(Listener& listener, boost::asio::yield_context yield);
   void on_accept(Listener& listener, tcp::socket stream);
 
+  int init_shards(const std::multimap<std::string, std::string>& config);
+  void start_shards();
+  void join_shards();
+
  public:
   AsioFrontend(RGWProcessEnv& env, RGWFrontendConfig* conf,
 	       dmc::SchedulerCtx& sched_ctx,
@@ -716,6 +745,11 @@ int AsioFrontend::init()
     listeners.emplace_back(context);
     listeners.back().endpoint = endpoint;
   }
+
+  if (int r = init_shards(config); r < 0) {
+    return r;
+  }
+
   // parse tcp nodelay
   auto nodelay = config.find("tcp_nodelay");
   if (nodelay != config.end()) {
@@ -729,6 +763,17 @@ int AsioFrontend::init()
   if (reuse_port_it != config.end()) {
     reuse_port = (reuse_port_it->second == "1");
   }
+  if (!shards.empty() && !reuse_port) {
+    // every shard binds its own listener to the same endpoint
+    if (reuse_port_it != config.end()) {
+      lderr(ctx()) << "io_shards requires so_reuseport, which is disabled "
+          "by so_reuseport=" << reuse_port_it->second << dendl;
+      return -EINVAL;
+    }
+    ldout(ctx(), 1) << "WARNING: enabling so_reuseport for io_shards; other "
+        "processes may now bind the same endpoints" << dendl;
+    reuse_port = true;
+  }
   bool socket_bound = false;
   // start listeners
   for (auto& l : listeners) {
@@ -788,11 +833,11 @@ int AsioFrontend::init()
     l.acceptor.listen(max_connection_backlog);
 
     // spawn a cancellable coroutine to the run the accept loop
-    boost::asio::spawn(context,
+    boost::asio::spawn(l.context,
       [this, &l] (boost::asio::yield_context yield) mutable {
         accept(l, yield);
       }, bind_cancellation_slot(l.signal.slot(),
-             bind_executor(context, boost::asio::detached)));
+             bind_executor(l.context, boost::asio::detached)));
 
     ldout(ctx(), 4) << "frontend listening on " << l.endpoint << dendl;
     socket_bound = true;
@@ -802,9 +847,158 @@ int AsioFrontend::init()
     return -EINVAL;
   }
 
+  start_shards();
+
   return drop_privileges(ctx());
 }
 
+// cpus the shard threads may be pinned to, in order
+static std::vector<int> shard_cpu_candidates(
+    CephContext* cct, const std::multimap<std::string, std::string>& config)
+{
+  std::vector<int> cpus;
+#if defined(__linux__)
+  size_t cpu_set_size = 0;
+  cpu_set_t cpu_set;
+  if (auto i = config.find("numa_node"); i != config.end()) {
+    auto node = ceph::parse<int>(i->second);
+    int r = node ? get_numa_node_cpu_set(*node, &cpu_set_size, &cpu_set)
+                 : -EINVAL;
+    if (r < 0) {
+      lderr(cct) << "WARNING: unable to get cpus of numa_node="
+          << i->second << ": " << cpp_strerror(r)
+          << ", io shards will not be pinned" << dendl;
+      return cpus;
+    }
+  } else if (auto i = config.find("io_shard_affinity");
+             i != config.end() && i->second == "1") {
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) < 0) {
+      int r = -errno;
+      lderr(cct) << "WARNING: sched_getaffinity failed: " << cpp_strerror(r)
+          << ", io shards will not be pinned" << dendl;
+      return cpus;
+    }
+    cpu_set_size = CPU_SETSIZE;
+  } else {
+    return cpus;
+  }
+  for (int cpu : cpu_set_to_set(cpu_set_size, &cpu_set)) {
+    cpus.push_back(cpu);
+  }
+#else
+  if (config.count("numa_node") || config.count("io_shard_affinity")) {
+    lderr(cct) << "WARNING: io shard cpu affinity is not supported "
+        "on this platform" << dendl;
+  }
+#endif
+  return cpus;
+}
+
+int AsioFrontend::init_shards(
+    const std::multimap<std::string, std::string>& config)
+{
+  auto i = config.find("io_shards");
+  if (i == config.end()) {
+    return 0;
+  }
+  auto count = ceph::parse<unsigned>(i->second);
+  if (!count) {
+    lderr(ctx()) << "failed to parse io_shards=" << i->second << dendl;
+    return -EINVAL;
+  }
+  if (*count == 0) {
+    return 0; // serve all listeners from the shared io_context
+  }
+
+  const unsigned pool_size = ctx()->_conf->rgw_thread_pool_size;
+  threads_per_shard = std::max(1u, pool_size / *count);
+  if (auto t = config.find("io_shard_threads"); t != config.end()) {
+    auto n = ceph::parse<unsigned>(t->second);
+    if (!n || *n == 0) {
+      lderr(ctx()) << "failed to parse io_shard_threads=" << t->second << dendl;
+      return -EINVAL;
+    }
+    threads_per_shard = *n;
+  }
+
+  // split the candidate cpus into one contiguous group per shard, so that a
+  // shard's threads stay on neighboring cpus. with more shards than cpus,
+  // shards share cpus round-robin
+  const auto cpus = shard_cpu_candidates(ctx(), config);
+  const size_t per_shard = std::max<size_t>(1, cpus.size() / *count);
+
+  shards.reserve(*count);
+  for (unsigned s = 0; s < *count; ++s) {
+    auto& shard = shards.emplace_back(
+        std::make_unique<IoShard>(threads_per_shard));
+    if (cpus.empty()) {
+      continue;
+    }
+    const size_t first = (s * per_shard) % cpus.size();
+    for (size_t c = 0; c < per_shard; ++c) {
+      shard->cpus.push_back(cpus[(first + c) % cpus.size()]);
+    }
+  }
+
+  // replace each listener with one per shard on the same endpoint
+  std::list<Listener> sharded;
+  for (const auto& l : listeners) {
+    for (auto& shard : shards) {
+      auto& s = sharded.emplace_back(shard->context);
+      s.endpoint = l.endpoint;
+      s.use_ssl = l.use_ssl;
+    }
+  }
+  listeners.swap(sharded);
+
+  ldout(ctx(), 4) << "frontend using " << shards.size() << " io shards with "
+      << threads_per_shard << " threads each" << dendl;
+  return 0;
+}
+
+void AsioFrontend::start_shards()
+{
+  for (size_t s = 0; s < shards.size(); ++s) {
+    auto& shard = *shards[s];
+    for (unsigned t = 0; t < threads_per_shard; ++t) {
+      shard.threads.push_back(make_named_thread("rgw_io_shard",
+        [this, &shard, s] {
+          is_asio_thread = true;
+#if defined(__linux__)
+          if (!shard.cpus.empty()) {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            for (int cpu : shard.cpus) {
+              CPU_SET(cpu, &cpu_set);
+            }
+            if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) < 0) {
+              int r = -errno;
+              ldout(ctx(), 1) << "WARNING: failed to pin io shard " << s
+                  << ": " << cpp_strerror(r) << dendl;
+            }
+          }
+#endif
+          shard.context.run();
+        }));
+    }
+  }
+}
+
+void AsioFrontend::join_shards()
+{
+  // let each shard's run() return once its connections have drained
+  for (auto& shard : shards) {
+    shard->work.reset();
+  }
+  for (auto& shard : shards) {
+    for (auto& t : shard->threads) {
+      t.join();
+    }
+    shard->threads.clear();
+  }
+}
+
 #ifdef WITH_RADOSGW_BEAST_OPENSSL
 
 static string config_val_prefix = "config://";
@@ -1221,8 +1415,8 @@ void AsioFrontend::on_accept(Listener& l, tcp::socket stream)
 #else
     const auto ssl_ctx = std::atomic_load_explicit(&ssl_context, std::memory_order_acquire);
 #endif
-    boost::asio::spawn(make_strand(context), std::allocator_arg, make_stack_allocator(),
-      [this, s=std::move(stream), ssl_ctx] (boost::asio::yield_context yield) mutable {
+    boost::asio::spawn(make_strand(l.context), std::allocator_arg, make_stack_allocator(),
+      [this, &context=l.context, s=std::move(stream), ssl_ctx] (boost::asio::yield_context yield) mutable {
         auto conn = boost::intrusive_ptr{new Connection(std::move(s))};
         auto c = connections.add(*conn);
         // wrap the tcp stream in an ssl stream
@@ -1256,8 +1450,8 @@ void AsioFrontend::on_accept(Listener& l, tcp::socket stream)
 #else
   {
 #endif // WITH_RADOSGW_BEAST_OPENSSL
-    boost::asio::spawn(make_strand(context), std::allocator_arg, make_stack_allocator(),
-      [this, s=std::move(stream)] (boost::asio::yield_context yield) mutable {
+    boost::asio::spawn(make_strand(l.context), std::allocator_arg, make_stack_allocator(),
+      [this, &context=l.context, s=std::move(stream)] (boost::asio::yield_context yield) mutable {
         auto conn = boost::intrusive_ptr{new Connection(std::move(s))};
         auto c = connections.add(*conn);
         auto timeout = timeout_timer{yield.get_executor(), request_timeout, conn};
@@ -1305,6 +1499,9 @@ void AsioFrontend::stop()
   // close all connections
   connections.close(ec);
   pause_mutex.cancel();
+
+  // wait for requests on io shards to finish before storage shuts down
+  join_shards();
 }
 
 void AsioFrontend::join()
@@ -1349,11 +1546,11 @@ void AsioFrontend::unpause()
 
   // start accepting connections again
   for (auto& l : listeners) {
-    boost::asio::spawn(context,
+    boost::asio::spawn(l.context,
       [this, &l] (boost::asio::yield_context yield) mutable {
         accept(l, yield);
       }, bind_cancellation_slot(l.signal.slot(),
-             bind_executor(context, boost::asio::detached)));
+             bind_executor(l.context, boost::asio::detached)));
 
   }
 
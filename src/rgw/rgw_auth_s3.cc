@@ -3,14 +3,17 @@
 
 #include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
+#include <functional>
 #include <map>
 #include <iterator>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "common/armor.h"
+#include "common/lru_map.h"
 #include "common/utf8.h"
 #include "common/split.h"
 #include "include/timegm.h"
@@ -952,15 +955,85 @@ transform_secret_key(const std::string_view& secret_access_key)
   return secret_key_utf8;
 }
 
+SigningKeyCache::SigningKeyCache(size_t max_entries)
+{
+  if (max_entries == 0) {
+    return;
+  }
+  const size_t per_shard = std::max<size_t>(1, max_entries / num_shards);
+  shards.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards.push_back(std::make_unique<shard_t>(per_shard));
+  }
+}
+
+std::string SigningKeyCache::make_key(const std::string_view& access_key_id,
+                                      const std::string_view& credential_scope)
+{
+  std::string key;
+  key.reserve(access_key_id.size() + 1 + credential_scope.size());
+  key.append(access_key_id);
+  key.push_back('\0');
+  key.append(credential_scope);
+  return key;
+}
+
+SigningKeyCache::shard_t& SigningKeyCache::shard_of(const std::string& key)
+{
+  return *shards[std::hash<std::string>{}(key) % num_shards];
+}
+
+bool SigningKeyCache::find(const std::string_view& access_key_id,
+                           const std::string_view& credential_scope,
+                           const std::string_view& secret_key,
+                           sha256_digest_t& signing_key)
+{
+  if (!enabled()) {
+    return false;
+  }
+  const auto key = make_key(access_key_id, credential_scope);
+  entry_t entry;
+  if (!shard_of(key).find(key, entry) ||
+      entry.secret_digest != calc_hash_sha256(secret_key)) {
+    return false;
+  }
+  signing_key = entry.signing_key;
+  return true;
+}
+
+void SigningKeyCache::add(const std::string_view& access_key_id,
+                          const std::string_view& credential_scope,
+                          const std::string_view& secret_key,
+                          const sha256_digest_t& signing_key)
+{
+  if (!enabled()) {
+    return;
+  }
+  const auto key = make_key(access_key_id, credential_scope);
+  entry_t entry{calc_hash_sha256(secret_key), signing_key};
+  shard_of(key).add(key, entry);
+}
+
 /*
  * calculate the SigningKey of AWS auth version 4
  */
 static sha256_digest_t
 get_v4_signing_key(CephContext* const cct,
+                   const std::string_view& access_key_id,
                    const std::string_view& credential_scope,
                    const std::string_view& secret_access_key,
                    const DoutPrefixProvider *dpp)
 {
+  static SigningKeyCache cache{
+    cct->_conf.get_val<uint64_t>("rgw_s3_auth_signing_key_cache_size")};
+
+  sha256_digest_t signing_key;
+  if (cache.find(access_key_id, credential_scope, secret_access_key,
+                 signing_key)) {
+    ldpp_dout(dpp, 10) << "signing_k = " << signing_key << " (cached)" << dendl;
+    return signing_key;
+  }
+
   std::string_view date, region, service;
   std::tie(date, region, service) = parse_cred_scope(credential_scope);
 
@@ -970,14 +1043,14 @@ get_v4_signing_key(CephContext* const cct,
   const auto service_k = calc_hmac_sha256(region_k, service);
 
   /* aws4_request */
-  const auto signing_key = calc_hmac_sha256(service_k,
-                                            std::string_view("aws4_request"));
+  signing_key = calc_hmac_sha256(service_k, std::string_view("aws4_request"));
 
   ldpp_dout(dpp, 10) << "date_k    = " << date_k << dendl;
   ldpp_dout(dpp, 10) << "region_k  = " << region_k << dendl;
   ldpp_dout(dpp, 10) << "service_k = " << service_k << dendl;
   ldpp_dout(dpp, 10) << "signing_k = " << signing_key << dendl;
 
+  cache.add(access_key_id, credential_scope, secret_access_key, signing_key);
   return signing_key;
 }
 
@@ -991,13 +1064,15 @@ get_v4_signing_key(CephContext* const cct,
  * dynamic allocations.
  */
 AWSEngine::VersionAbstractor::server_signature_t
-get_v4_signature(const std::string_view& credential_scope,
+get_v4_signature(const std::string_view& access_key_id,
+                 const std::string_view& credential_scope,
                  CephContext* const cct,
                  const std::string_view& secret_key,
                  const AWSEngine::VersionAbstractor::string_to_sign_t& string_to_sign,
                  const DoutPrefixProvider *dpp)
 {
-  auto signing_key = get_v4_signing_key(cct, credential_scope, secret_key, dpp);
+  auto signing_key = get_v4_signing_key(cct, access_key_id, credential_scope,
+                                        secret_key, dpp);
 
   /* The server-side generated digest for comparison. */
   const auto digest = calc_hmac_sha256(signing_key, string_to_sign);
@@ -1644,6 +1719,7 @@ bool AWSv4ComplMulti::complete()
 rgw::auth::Completer::cmplptr_t
 AWSv4ComplMulti::create(const req_state* const s,
                         std::string_view date,
+                        std::string_view access_key_id,
                         std::string_view credential_scope,
                         std::string_view seed_signature,
 			uint32_t flags,
@@ -1657,7 +1733,8 @@ AWSv4ComplMulti::create(const req_state* const s,
   }
 
   const auto signing_key = \
-    rgw::auth::s3::get_v4_signing_key(s->cct, credential_scope, *secret_key, s);
+    rgw::auth::s3::get_v4_signing_key(s->cct, access_key_id, credential_scope,
+                                      *secret_key, s);
 
   return std::make_shared<AWSv4ComplMulti>(s,
                                            std::move(date),
@@ -15,6 +15,7 @@
 #include <boost/container/static_vector.hpp>
 #include <boost/container/flat_map.hpp>
 
+#include "common/lru_map.h"
 #include "common/sstring.hh"
 #include "rgw_common.h"
 #include "rgw_rest_s3.h"
@@ -446,6 +447,7 @@ class AWSv4ComplMulti : public rgw::auth::Completer,
   /* Factories. */
   static cmplptr_t create(const req_state* s,
                           std::string_view date,
+                          std::string_view access_key_id,
                           std::string_view credential_scope,
                           std::string_view seed_signature,
 			  uint32_t flags,
@@ -736,8 +738,43 @@ get_v4_string_to_sign(CephContext* cct,
                       const sha256_digest_t& canonreq_hash,
                       const DoutPrefixProvider *dpp);
 
+/* Derived SigV4 signing keys only change with the date, region and service
+ * of the credential scope, so they are reused across requests. Entries are
+ * keyed by access key id and credential scope; each one keeps a digest of the
+ * secret key it was derived from, so a rotated secret misses instead of being
+ * served a stale signing key. */
+class SigningKeyCache {
+  struct entry_t {
+    sha256_digest_t secret_digest;
+    sha256_digest_t signing_key;
+  };
+  static constexpr size_t num_shards = 16;
+  using shard_t = lru_map<std::string, entry_t>;
+  std::vector<std::unique_ptr<shard_t>> shards;
+
+  static std::string make_key(const std::string_view& access_key_id,
+                              const std::string_view& credential_scope);
+  shard_t& shard_of(const std::string& key);
+
+public:
+  /// max_entries == 0 disables the cache
+  explicit SigningKeyCache(size_t max_entries);
+
+  bool enabled() const { return !shards.empty(); }
+
+  bool find(const std::string_view& access_key_id,
+            const std::string_view& credential_scope,
+            const std::string_view& secret_key,
+            sha256_digest_t& signing_key);
+  void add(const std::string_view& access_key_id,
+           const std::string_view& credential_scope,
+           const std::string_view& secret_key,
+           const sha256_digest_t& signing_key);
+};
+
 extern AWSEngine::VersionAbstractor::server_signature_t
-get_v4_signature(const std::string_view& credential_scope,
+get_v4_signature(const std::string_view& access_key_id,
+                 const std::string_view& credential_scope,
                  CephContext* const cct,
                  const std::string_view& secret_key,
                  const AWSEngine::VersionAbstractor::string_to_sign_t& string_to_sign,
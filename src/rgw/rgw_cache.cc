@@ -6,71 +6,112 @@
 
 #include <errno.h>
 
+#include <algorithm>
+#include <bit>
+
 #define dout_subsys ceph_subsys_rgw
 
 using namespace std;
 
-int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
+namespace {
+// take a shard lock, counting the times we had to wait for it
+template <typename Lock>
+void lock_shard(Lock& l, std::atomic<uint64_t>& contended)
 {
+  if (!l.try_lock()) {
+    contended.fetch_add(1, std::memory_order_relaxed);
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_cache_lock_contended);
+    }
+    l.lock();
+  }
+}
+} // anonymous namespace
 
-  std::shared_lock rl{lock};
-  std::unique_lock wl{lock, std::defer_lock}; // may be promoted to write lock
+void ObjectCache::set_ctx(CephContext *_cct)
+{
+  cct = _cct;
+  const auto num_shards = std::bit_ceil(std::clamp<uint64_t>(
+      cct->_conf.get_val<uint64_t>("rgw_cache_shards"), 1, 1024));
+  shards = std::vector<Shard>(num_shards);
+  lru_window = shard_lru_max() / 2;
+  expiry = std::chrono::seconds(cct->_conf.get_val<uint64_t>(
+					      "rgw_cache_expiry_interval"));
+}
+
+unsigned long ObjectCache::shard_lru_max() const
+{
+  return std::max<unsigned long>(
+      1, (unsigned long)cct->_conf->rgw_cache_lru_size / shards.size());
+}
+
+int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, uint32_t mask, rgw_cache_entry_info *cache_info)
+{
   if (!enabled) {
     return -ENOENT;
   }
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end()) {
-    ldpp_dout(dpp, 10) << "cache get: name=" << name << " : miss" << dendl;
+  auto& shard = shard_of(name);
+  std::shared_lock rl{shard.lock, std::defer_lock};
+  std::unique_lock wl{shard.lock, std::defer_lock}; // may be promoted to write lock
+  lock_shard(rl, shard.contended);
+
+  auto miss = [&shard] {
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
     if (perfcounter) {
       perfcounter->inc(l_rgw_cache_miss);
     }
     return -ENOENT;
+  };
+
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end()) {
+    ldpp_dout(dpp, 10) << "cache get: name=" << name << " : miss" << dendl;
+    return miss();
   }
 
   if (expiry.count() &&
        (ceph::coarse_mono_clock::now() - iter->second.info.time_added) > expiry) {
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : expiry miss" << dendl;
     rl.unlock();
-    wl.lock(); // write lock for expiration
+    lock_shard(wl, shard.contended); // write lock for expiration
     // check that wasn't already removed by other thread
-    iter = cache_map.find(name);
-    if (iter != cache_map.end()) {
+    iter = shard.cache_map.find(name);
+    if (iter != shard.cache_map.end()) {
       for (auto &kv : iter->second.chained_entries)
         kv.first->invalidate(kv.second);
-      remove_lru(name, iter->second.lru_iter);
-      cache_map.erase(iter);
-    }
-    if (perfcounter) {
-      perfcounter->inc(l_rgw_cache_miss);
+      remove_lru(shard, name, iter->second.lru_iter);
+      shard.cache_map.erase(iter);
     }
-    return -ENOENT;
+    return miss();
   }
 
   ObjectCacheEntry *entry = &iter->second;
 
-  if (lru_counter - entry->lru_promotion_ts > lru_window) {
-    ldpp_dout(dpp, 20) << "cache get: touching lru, lru_counter=" << lru_counter
+  // hits only move an entry to the LRU end once it has aged by half
+  // the shard's capacity, so most hits stay under the shared lock
+  if (shard.lru_counter - entry->lru_promotion_ts > lru_window) {
+    ldpp_dout(dpp, 20) << "cache get: touching lru, lru_counter=" << shard.lru_counter
                    << " promotion_ts=" << entry->lru_promotion_ts << dendl;
     rl.unlock();
-    wl.lock(); // write lock for touch_lru()
+    lock_shard(wl, shard.contended); // write lock for touch_lru()
     /* need to redo this because entry might have dropped off the cache */
-    iter = cache_map.find(name);
-    if (iter == cache_map.end()) {
+    iter = shard.cache_map.find(name);
+    if (iter == shard.cache_map.end()) {
       ldpp_dout(dpp, 10) << "lost race! cache get: name=" << name << " : miss" << dendl;
-      if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
-      return -ENOENT;
+      return miss();
     }
 
     entry = &iter->second;
     /* check again, we might have lost a race here */
-    if (lru_counter - entry->lru_promotion_ts > lru_window) {
-      touch_lru(dpp, name, *entry, iter->second.lru_iter);
+    if (shard.lru_counter - entry->lru_promotion_ts > lru_window) {
+      touch_lru(dpp, shard, name, *entry, iter->second.lru_iter);
     }
   }
 
   ObjectCacheInfo& src = iter->second.info;
   if(src.status == -ENOENT) {
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : hit (negative entry)" << dendl;
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
     if (perfcounter) perfcounter->inc(l_rgw_cache_hit);
     return -ENODATA;
   }
@@ -78,8 +119,7 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
     ldpp_dout(dpp, 10) << "cache get: name=" << name << " : type miss (requested=0x"
                    << std::hex << mask << ", cached=0x" << src.flags
                    << std::dec << ")" << dendl;
-    if(perfcounter) perfcounter->inc(l_rgw_cache_miss);
-    return -ENOENT;
+    return miss();
   }
   ldpp_dout(dpp, 10) << "cache get: name=" << name << " : hit (requested=0x"
                  << std::hex << mask << ", cached=0x" << src.flags
@@ -90,6 +130,7 @@ int ObjectCache::get(const DoutPrefixProvider *dpp, const string& name, ObjectCa
     cache_info->cache_locator = name;
     cache_info->gen = entry->gen;
   }
+  shard.hits.fetch_add(1, std::memory_order_relaxed);
   if(perfcounter) perfcounter->inc(l_rgw_cache_hit);
 
   return 0;
@@ -99,20 +140,35 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
                                     std::initializer_list<rgw_cache_entry_info*> cache_info_entries,
 				    RGWChainedCache::Entry *chained_entry)
 {
-  std::unique_lock l{lock};
-
   if (!enabled) {
     return false;
   }
 
+  // lock every shard involved, in address order to avoid deadlocking
+  // with a concurrent chain_cache_entry() on the same shards
+  std::vector<Shard*> locked;
+  locked.reserve(cache_info_entries.size());
+  for (auto cache_info : cache_info_entries) {
+    locked.push_back(&shard_of(cache_info->cache_locator));
+  }
+  std::sort(locked.begin(), locked.end());
+  locked.erase(std::unique(locked.begin(), locked.end()), locked.end());
+  std::vector<std::unique_lock<ceph::shared_mutex>> locks;
+  locks.reserve(locked.size());
+  for (auto shard : locked) {
+    auto& l = locks.emplace_back(shard->lock, std::defer_lock);
+    lock_shard(l, shard->contended);
+  }
+
   std::vector<ObjectCacheEntry*> entries;
   entries.reserve(cache_info_entries.size());
   /* first verify that all entries are still valid */
   for (auto cache_info : cache_info_entries) {
     ldpp_dout(dpp, 10) << "chain_cache_entry: cache_locator="
 		   << cache_info->cache_locator << dendl;
-    auto iter = cache_map.find(cache_info->cache_locator);
-    if (iter == cache_map.end()) {
+    auto& shard = shard_of(cache_info->cache_locator);
+    auto iter = shard.cache_map.find(cache_info->cache_locator);
+    if (iter == shard.cache_map.end()) {
       ldpp_dout(dpp, 20) << "chain_cache_entry: couldn't find cache locator" << dendl;
       return false;
     }
@@ -141,20 +197,22 @@ bool ObjectCache::chain_cache_entry(const DoutPrefixProvider *dpp,
 
 void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectCacheInfo& info, rgw_cache_entry_info *cache_info)
 {
-  std::unique_lock l{lock};
-
   if (!enabled) {
     return;
   }
 
+  auto& shard = shard_of(name);
+  std::unique_lock l{shard.lock, std::defer_lock};
+  lock_shard(l, shard.contended);
+
   ldpp_dout(dpp, 10) << "cache put: name=" << name << " info.flags=0x"
                  << std::hex << info.flags << std::dec << dendl;
 
-  auto [iter, inserted] = cache_map.emplace(name, ObjectCacheEntry{});
+  auto [iter, inserted] = shard.cache_map.emplace(name, ObjectCacheEntry{});
   ObjectCacheEntry& entry = iter->second;
   entry.info.time_added = ceph::coarse_mono_clock::now();
   if (inserted) {
-    entry.lru_iter = lru.end();
+    entry.lru_iter = shard.lru.end();
   }
   ObjectCacheInfo& target = entry.info;
 
@@ -163,7 +221,7 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
   entry.chained_entries.clear();
   entry.gen++;
 
-  touch_lru(dpp, name, entry, entry.lru_iter);
+  touch_lru(dpp, shard, name, entry, entry.lru_iter);
 
   target.status = info.status;
 
@@ -218,14 +276,16 @@ void ObjectCache::put(const DoutPrefixProvider *dpp, const string& name, ObjectC
 // negative lookup. It must only invalidate.
 bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string& name)
 {
-  std::unique_lock l{lock};
-
   if (!enabled) {
     return false;
   }
 
-  auto iter = cache_map.find(name);
-  if (iter == cache_map.end())
+  auto& shard = shard_of(name);
+  std::unique_lock l{shard.lock, std::defer_lock};
+  lock_shard(l, shard.contended);
+
+  auto iter = shard.cache_map.find(name);
+  if (iter == shard.cache_map.end())
     return false;
 
   ldpp_dout(dpp, 10) << "removing " << name << " from cache" << dendl;
@@ -235,16 +295,18 @@ bool ObjectCache::invalidate_remove(const DoutPrefixProvider *dpp, const string&
     kv.first->invalidate(kv.second);
   }
 
-  remove_lru(name, iter->second.lru_iter);
-  cache_map.erase(iter);
+  remove_lru(shard, name, iter->second.lru_iter);
+  shard.cache_map.erase(iter);
   return true;
 }
 
-void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, ObjectCacheEntry& entry,
+void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+                            const string& name, ObjectCacheEntry& entry,
 			    std::list<string>::iterator& lru_iter)
 {
-  while (lru_size > (size_t)cct->_conf->rgw_cache_lru_size) {
-    auto iter = lru.begin();
+  const auto lru_max = shard_lru_max();
+  while (shard.lru_size > lru_max) {
+    auto iter = shard.lru.begin();
     if ((*iter).compare(name) == 0) {
       /*
        * if the entry we're touching happens to be at the lru end, don't remove it,
@@ -252,43 +314,43 @@ void ObjectCache::touch_lru(const DoutPrefixProvider *dpp, const string& name, O
        */
       break;
     }
-    auto map_iter = cache_map.find(*iter);
+    auto map_iter = shard.cache_map.find(*iter);
     ldout(cct, 10) << "removing entry: name=" << *iter << " from cache LRU" << dendl;
-    if (map_iter != cache_map.end()) {
+    if (map_iter != shard.cache_map.end()) {
       ObjectCacheEntry& entry = map_iter->second;
       invalidate_lru(entry);
-      cache_map.erase(map_iter);
+      shard.cache_map.erase(map_iter);
     }
-    lru.pop_front();
-    lru_size--;
+    shard.lru.pop_front();
+    shard.lru_size--;
   }
 
-  if (lru_iter == lru.end()) {
-    lru.push_back(name);
-    lru_size++;
+  if (lru_iter == shard.lru.end()) {
+    shard.lru.push_back(name);
+    shard.lru_size++;
     lru_iter--;
     ldpp_dout(dpp, 10) << "adding " << name << " to cache LRU end" << dendl;
   } else {
     ldpp_dout(dpp, 10) << "moving " << name << " to cache LRU end" << dendl;
-    lru.erase(lru_iter);
-    lru.push_back(name);
-    lru_iter = lru.end();
+    shard.lru.erase(lru_iter);
+    shard.lru.push_back(name);
+    lru_iter = shard.lru.end();
     --lru_iter;
   }
 
-  lru_counter++;
-  entry.lru_promotion_ts = lru_counter;
+  shard.lru_counter++;
+  entry.lru_promotion_ts = shard.lru_counter;
 }
 
-void ObjectCache::remove_lru(const string& name,
+void ObjectCache::remove_lru(Shard& shard, const string& name,
 			     std::list<string>::iterator& lru_iter)
 {
-  if (lru_iter == lru.end())
+  if (lru_iter == shard.lru.end())
     return;
 
-  lru.erase(lru_iter);
-  lru_size--;
-  lru_iter = lru.end();
+  shard.lru.erase(lru_iter);
+  shard.lru_size--;
+  lru_iter = shard.lru.end();
 }
 
 void ObjectCache::invalidate_lru(ObjectCacheEntry& entry)
@@ -320,12 +382,14 @@ void ObjectCache::invalidate_all()
 
 void ObjectCache::do_invalidate_all()
 {
-  cache_map.clear();
-  lru.clear();
+  for (auto& shard : shards) {
+    std::unique_lock l{shard.lock};
+    shard.cache_map.clear();
+    shard.lru.clear();
 
-  lru_size = 0;
-  lru_counter = 0;
-  lru_window = 0;
+    shard.lru_size = 0;
+    shard.lru_counter = 0;
+  }
 
   for (auto& cache : chained_cache) {
     cache->invalidate_all();
@@ -350,6 +414,26 @@ void ObjectCache::unchain_cache(RGWChainedCache *cache) {
   }
 }
 
+void ObjectCache::dump_stats(Formatter *f)
+{
+  f->open_array_section("shards");
+  for (auto& shard : shards) {
+    size_t entries;
+    {
+      std::shared_lock l{shard.lock};
+      entries = shard.cache_map.size();
+    }
+    f->open_object_section("shard");
+    f->dump_unsigned("entries", entries);
+    f->dump_unsigned("hits", shard.hits.load(std::memory_order_relaxed));
+    f->dump_unsigned("misses", shard.misses.load(std::memory_order_relaxed));
+    f->dump_unsigned("contended",
+                     shard.contended.load(std::memory_order_relaxed));
+    f->close_section();
+  }
+  f->close_section();
+}
+
 ObjectCache::~ObjectCache()
 {
   for (auto cache : chained_cache) {
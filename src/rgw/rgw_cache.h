@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <shared_mutex> // for std::shared_lock
 #include <string>
 #include <map>
@@ -160,28 +161,48 @@ struct ObjectCacheEntry {
 };
 
 class ObjectCache {
-  std::unordered_map<std::string, ObjectCacheEntry> cache_map;
-  std::list<std::string> lru;
-  unsigned long lru_size;
-  unsigned long lru_counter;
+  // entries are spread over independently locked shards by name hash,
+  // each with its own LRU, so lookups of unrelated metadata objects
+  // don't serialize on one lock
+  struct Shard {
+    std::unordered_map<std::string, ObjectCacheEntry> cache_map;
+    std::list<std::string> lru;
+    unsigned long lru_size = 0;
+    unsigned long lru_counter = 0;
+    ceph::shared_mutex lock = ceph::make_shared_mutex("ObjectCache::Shard");
+
+    // for "cache stats"; updated without the lock held exclusively
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> contended{0};
+  };
+  std::vector<Shard> shards;
   unsigned long lru_window;
+  // guards chained_cache; taken before any shard lock
   ceph::shared_mutex lock = ceph::make_shared_mutex("ObjectCache");
   CephContext *cct;
 
   std::vector<RGWChainedCache *> chained_cache;
 
-  bool enabled;
+  std::atomic<bool> enabled;
   ceph::timespan expiry;
 
-  void touch_lru(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheEntry& entry,
+  Shard& shard_of(const std::string& name) {
+    return shards[std::hash<std::string>{}(name) & (shards.size() - 1)];
+  }
+  unsigned long shard_lru_max() const;
+
+  void touch_lru(const DoutPrefixProvider *dpp, Shard& shard,
+                 const std::string& name, ObjectCacheEntry& entry,
 		 std::list<std::string>::iterator& lru_iter);
-  void remove_lru(const std::string& name, std::list<std::string>::iterator& lru_iter);
+  void remove_lru(Shard& shard, const std::string& name,
+                  std::list<std::string>::iterator& lru_iter);
   void invalidate_lru(ObjectCacheEntry& entry);
 
   void do_invalidate_all();
 
 public:
-  ObjectCache() : lru_size(0), lru_counter(0), lru_window(0), cct(NULL), enabled(false) { }
+  ObjectCache() : shards(1), lru_window(0), cct(NULL), enabled(false) { }
   ~ObjectCache();
   int get(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheInfo& bl, uint32_t mask, rgw_cache_entry_info *cache_info);
   std::optional<ObjectCacheInfo> get(const DoutPrefixProvider *dpp, const std::string& name) {
@@ -192,12 +213,14 @@ public:
 
   template<typename F>
   void for_each(const F& f) {
-    std::shared_lock l{lock};
     if (enabled) {
       auto now  = ceph::coarse_mono_clock::now();
-      for (const auto& [name, entry] : cache_map) {
-        if (expiry.count() && (now - entry.info.time_added) < expiry) {
-          f(name, entry);
+      for (auto& shard : shards) {
+        std::shared_lock l{shard.lock};
+        for (const auto& [name, entry] : shard.cache_map) {
+          if (expiry.count() && (now - entry.info.time_added) < expiry) {
+            f(name, entry);
+          }
         }
       }
     }
@@ -205,12 +228,7 @@ public:
 
   void put(const DoutPrefixProvider *dpp, const std::string& name, ObjectCacheInfo& bl, rgw_cache_entry_info *cache_info);
   bool invalidate_remove(const DoutPrefixProvider *dpp, const std::string& name);
-  void set_ctx(CephContext *_cct) {
-    cct = _cct;
-    lru_window = cct->_conf->rgw_cache_lru_size / 2;
-    expiry = std::chrono::seconds(cct->_conf.get_val<uint64_t>(
-						"rgw_cache_expiry_interval"));
-  }
+  void set_ctx(CephContext *_cct);
   bool chain_cache_entry(const DoutPrefixProvider *dpp,
                          std::initializer_list<rgw_cache_entry_info*> cache_info_entries,
 			 RGWChainedCache::Entry *chained_entry);
@@ -220,4 +238,9 @@ public:
   void chain_cache(RGWChainedCache *cache);
   void unchain_cache(RGWChainedCache *cache);
   void invalidate_all();
+
+  size_t get_num_shards() const {
+    return shards.size();
+  }
+  void dump_stats(Formatter *f);
 };
@@ -74,9 +74,20 @@ namespace rgw::putobj {
 
   int RGWPutObj_Cksum::process(ceph::buffer::list &&data, uint64_t logical_offset)
   {
+    if (!etag_hash) {
+      hash_buffers(*_digest, data);
+      return Pipe::process(std::move(data), logical_offset);
+    }
+    /* walk each buffer in slices that stay cache-resident between the
+     * two hashes, rather than streaming the whole list through each */
+    constexpr size_t slice_len = 64 * 1024;
     for (const auto& ptr : data.buffers()) {
-      _digest->Update(reinterpret_cast<const unsigned char*>(ptr.c_str()),
-                      ptr.length());
+      auto p = reinterpret_cast<const unsigned char*>(ptr.c_str());
+      for (size_t off = 0; off < ptr.length(); off += slice_len) {
+	const size_t len = std::min<size_t>(slice_len, ptr.length() - off);
+	_digest->Update(p + off, len);
+	etag_hash->Update(p + off, len);
+      }
     }
     return Pipe::process(std::move(data), logical_offset);
   }
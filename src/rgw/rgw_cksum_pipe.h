@@ -175,6 +175,15 @@ namespace rgw::putobj {
     return cksum_flags;
   } /* parse_cksum_flags */
 
+  /* feed each buffer of data to hash, without flattening the list */
+  template <typename Hash>
+  static inline void hash_buffers(Hash& hash, const ceph::buffer::list& data) {
+    for (const auto& ptr : data.buffers()) {
+      hash.Update(reinterpret_cast<const unsigned char*>(ptr.c_str()),
+		  ptr.length());
+    }
+  }
+
   // PutObj filter for streaming checksums
   class RGWPutObj_Cksum : public rgw::putobj::Pipe {
 
@@ -184,6 +193,8 @@ namespace rgw::putobj {
     cksum::Digest* _digest;
     cksum::Cksum _cksum;
     cksum_hdr_t cksum_hdr;
+    /* the caller's ETag hash, when fused into our pass over the data */
+    MD5* etag_hash{nullptr};
 
   public:
 
@@ -200,6 +211,12 @@ namespace rgw::putobj {
 
     cksum::Type type() { return _type; }
     cksum::Digest* digest() const { return _digest; }
+
+    /* also update etag with all data passing through, interleaved with
+     * the checksum digest so each buffer is read from memory once;
+     * the caller must then not hash the data itself */
+    void fuse_etag_hash(MD5* etag) { etag_hash = etag; }
+    bool has_etag_hash() const { return etag_hash != nullptr; }
     const cksum::Cksum& cksum() { return _cksum; };
 
     const cksum_hdr_t& header() const {
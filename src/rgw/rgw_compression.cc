@@ -42,6 +42,49 @@ int rgw_compression_info_from_attrset(const map<string, bufferlist>& attrs,
 
 //------------RGWPutObj_Compress---------------
 
+RGWPutObj_Compress::RGWPutObj_Compress(CephContext* cct_,
+                                       CompressorRef compressor,
+                                       rgw::sal::DataProcessor *next,
+                                       optional_yield y)
+  : Pipe(next), cct(cct_), compressor(compressor)
+{
+  const auto max_parts = cct->_conf.get_val<uint64_t>("rgw_put_obj_parallel_parts");
+  if (y && max_parts > 1) {
+    parallel.emplace(cct, &sink,
+        [compressor, cct_] (bufferlist& data, uint64_t logical_offset) {
+          bufferlist out;
+          std::optional<int32_t> message; // already captured from the first part
+          int cr = compressor->compress(data, out, message);
+          if (cr < 0) {
+            lderr(cct_) << "Compression failed with exit code " << cr
+                << " for part at " << logical_offset
+                << ", compression process failed" << dendl;
+            return -EIO;
+          }
+          data = std::move(out);
+          return 0;
+        }, max_parts, y);
+  }
+}
+
+int RGWPutObj_Compress::write_block(bufferlist&& out, uint64_t logical_offset)
+{
+  size_t bs = blocks.size();
+  if (out.length() == 0) { // flush
+    compressed_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : logical_offset;
+    return Pipe::process({}, compressed_ofs);
+  }
+
+  compression_block newbl;
+  newbl.old_ofs = logical_offset;
+  newbl.new_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : 0;
+  newbl.len = out.length();
+  blocks.push_back(newbl);
+
+  compressed_ofs = newbl.new_ofs;
+  return Pipe::process(std::move(out), compressed_ofs);
+}
+
 int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
 {
   bufferlist out;
@@ -49,6 +92,13 @@ int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
 
   if (in.length() > 0) {
     // compression stuff
+    if (logical_offset > 0 && compressed && parallel) {
+      // the first part settled that we compress; later parts don't
+      // depend on each other
+      ldout(cct, 10) << "Compression for rgw is enabled, compress part " << in.length()
+          << " in parallel" << dendl;
+      return parallel->process(std::move(in), logical_offset);
+    }
     if ((logical_offset > 0 && compressed) || // if previous part was compressed
         (logical_offset == 0)) {              // or it's the first part
       ldout(cct, 10) << "Compression for rgw is enabled, compress part " << in.length() << dendl;
@@ -65,24 +115,18 @@ int RGWPutObj_Compress::process(bufferlist&& in, uint64_t logical_offset)
         out = std::move(in);
       } else {
         compressed = true;
-    
-        compression_block newbl;
-        size_t bs = blocks.size();
-        newbl.old_ofs = logical_offset;
-        newbl.new_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : 0;
-        newbl.len = out.length();
-        blocks.push_back(newbl);
-
-	compressed_ofs = newbl.new_ofs;
+        return write_block(std::move(out), logical_offset);
       }
     } else {
       compressed = false;
       out = std::move(in);
     }
     // end of compression stuff
+  } else if (parallel && compressed) {
+    // pass on the parts still in flight, then the flush itself
+    return parallel->process({}, logical_offset);
   } else {
-    size_t bs = blocks.size();
-    compressed_ofs = bs > 0 ? blocks[bs-1].len + blocks[bs-1].new_ofs : logical_offset;
+    return write_block({}, logical_offset);
   }
 
   return Pipe::process(std::move(out), compressed_ofs);
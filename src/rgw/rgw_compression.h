@@ -47,10 +47,25 @@ class RGWPutObj_Compress : public rgw::putobj::Pipe
   std::optional<int32_t> compressor_message;
   std::vector<compression_block> blocks;
   uint64_t compressed_ofs{0};
+
+  // records the block for a compressed part (or handles the final
+  // flush) and passes it on; parts must arrive in order
+  int write_block(bufferlist&& out, uint64_t logical_offset);
+
+  // parts after the first are compressed by `parallel` when
+  // rgw_put_obj_parallel_parts allows it, and come back through `sink`
+  struct BlockSink : rgw::sal::DataProcessor {
+    RGWPutObj_Compress* parent;
+    explicit BlockSink(RGWPutObj_Compress* parent) : parent(parent) {}
+    int process(bufferlist&& data, uint64_t logical_offset) override {
+      return parent->write_block(std::move(data), logical_offset);
+    }
+  } sink{this};
+  std::optional<rgw::putobj::ParallelProcessor> parallel;
 public:
   RGWPutObj_Compress(CephContext* cct_, CompressorRef compressor,
-                     rgw::sal::DataProcessor *next)
-    : Pipe(next), cct(cct_), compressor(compressor) {}
+                     rgw::sal::DataProcessor *next,
+                     optional_yield y = null_yield);
   virtual ~RGWPutObj_Compress() override {};
 
   int process(bufferlist&& data, uint64_t logical_offset) override;
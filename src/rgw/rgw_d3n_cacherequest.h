@@ -8,6 +8,10 @@
 #include <aio.h>
 
 #include <boost/asio/spawn.hpp>
+#if defined(BOOST_ASIO_HAS_FILE)
+#include <boost/asio/random_access_file.hpp>
+#include <boost/asio/read_at.hpp>
+#endif
 
 #include "include/rados/librados.hpp"
 #include "include/Context.h"
@@ -139,6 +143,54 @@ struct D3nL1CacheRequest {
     }
   };
 
+#if defined(BOOST_ASIO_HAS_FILE)
+  // read the cache file through asio's io_uring file support. the read
+  // completes on the caller's executor without taking a libaio thread.
+  // returns false if io_uring is not usable, so the caller can fall back
+  // to libaio
+  bool file_uring_read(const DoutPrefixProvider *dpp, const boost::asio::any_io_executor& ex,
+                       const std::string& location, off_t read_ofs, off_t read_len,
+                       rgw::Aio* aio, rgw::AioResult& r) {
+    static std::atomic<bool> uring_unavailable{false};
+    if (uring_unavailable) {
+      return false;
+    }
+    std::shared_ptr<boost::asio::random_access_file> file;
+    boost::system::error_code ec;
+    try {
+      file = std::make_shared<boost::asio::random_access_file>(ex);
+    } catch (const boost::system::system_error& e) {
+      ldpp_dout(dpp, 1) << "D3nDataCache: " << __func__ << "(): io_uring not available, using libaio: " << e.what() << dendl;
+      uring_unavailable = true;
+      return false;
+    }
+    file->open(location, boost::asio::file_base::read_only, ec);
+    if (ec) {
+      ldpp_dout(dpp, 1) << "ERROR: D3nDataCache: " << __func__ << "(): can't open " << location << " : " << ec.message() << dendl;
+      boost::asio::post(ex, [h = d3n_libaio_handler{aio, r}, ec] { h(ec, bufferlist{}); });
+      return true;
+    }
+    if (g_conf()->rgw_d3n_l1_fadvise != POSIX_FADV_NORMAL)
+      posix_fadvise(file->native_handle(), 0, 0, g_conf()->rgw_d3n_l1_fadvise);
+
+    bufferptr bp(read_len);
+    auto buffer = boost::asio::buffer(bp.c_str(), read_len);
+    boost::asio::async_read_at(*file, read_ofs, buffer, boost::asio::bind_executor(ex,
+        [file, bp = std::move(bp), h = d3n_libaio_handler{aio, r}] (boost::system::error_code ec, size_t) mutable {
+          if (ec == boost::asio::error::eof) {
+            // the cache file is shorter than the chunk
+            ec = boost::system::error_code{EIO, boost::system::system_category()};
+          }
+          bufferlist bl;
+          if (!ec) {
+            bl.append(std::move(bp));
+          }
+          h(ec, std::move(bl));
+        }));
+    return true;
+  }
+#endif
+
   static std::string generate_oid_digest(const std::string& oid) {
     XXH128_hash_t hash = XXH3_128bits(oid.c_str(), oid.size());
     std::string digest = fmt::format("{:016x}{:016x}", hash.high64, hash.low64);
@@ -150,7 +202,14 @@ struct D3nL1CacheRequest {
                               rgw::Aio* aio, rgw::AioResult& r) {
     auto ex = yield.get_executor();
     ldpp_dout(dpp, 20) << "D3nDataCache: " << __func__ << "(): oid=" << r.obj.oid << dendl;
-    async_read(dpp, ex, cache_location+"/"+generate_oid_digest(r.obj.oid), read_ofs, read_len, bind_executor(ex, d3n_libaio_handler{aio, r}));
+    const auto location = cache_location+"/"+generate_oid_digest(r.obj.oid);
+#if defined(BOOST_ASIO_HAS_FILE)
+    if (g_conf()->rgw_d3n_l1_io_uring &&
+        file_uring_read(dpp, ex, location, read_ofs, read_len, aio, r)) {
+      return;
+    }
+#endif
+    async_read(dpp, ex, location, read_ofs, read_len, bind_executor(ex, d3n_libaio_handler{aio, r}));
   }
 
 };
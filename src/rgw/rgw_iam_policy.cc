@@ -1870,6 +1870,23 @@ Policy::Policy(CephContext* cct, const string* tenant,
   if (!pr) {
     throw PolicyParseException(pr, pp.annotation);
   }
+  compile();
+}
+
+void Policy::compile()
+{
+  action_offsets.assign(allCount + 1, 0);
+  action_statements.clear();
+  for (std::uint64_t a = 0; a < allCount; ++a) {
+    action_offsets[a] = action_statements.size();
+    for (std::uint32_t i = 0; i < statements.size(); ++i) {
+      const auto& s = statements[i];
+      if (s.action[a] && !s.notaction[a]) {
+        action_statements.push_back(i);
+      }
+    }
+  }
+  action_offsets[allCount] = action_statements.size();
 }
 
 Effect Policy::eval(const Environment& e,
@@ -1877,14 +1894,36 @@ Effect Policy::eval(const Environment& e,
 		    std::uint64_t action, boost::optional<const ARN&> resource,
         boost::optional<PolicyPrincipal&> princ_type) const {
   auto allowed = false;
-  for (auto& s : statements) {
-    auto g = s.eval(e, ida, action, resource, princ_type);
+  if (action >= allCount || action_offsets.size() != allCount + 1) {
+    for (auto& s : statements) {
+      auto g = s.eval(e, ida, action, resource, princ_type);
+      if (g == Effect::Deny) {
+        return g;
+      } else if (g == Effect::Allow) {
+        allowed = true;
+      }
+    }
+    return allowed ? Effect::Allow : Effect::Pass;
+  }
+
+  // statements that don't name the action can only Pass
+  const auto first = action_offsets[action];
+  const auto last = action_offsets[action + 1];
+  for (auto i = first; i < last; ++i) {
+    auto g = statements[action_statements[i]].eval(e, ida, action, resource,
+                                                   princ_type);
     if (g == Effect::Deny) {
       return g;
     } else if (g == Effect::Allow) {
       allowed = true;
     }
   }
+  // princ_type reflects the last statement's principal, as it would if
+  // every statement had been evaluated
+  if (princ_type && !statements.empty() &&
+      (first == last || action_statements[last - 1] != statements.size() - 1)) {
+    statements.back().eval_principal(e, ida, princ_type);
+  }
   return allowed ? Effect::Allow : Effect::Pass;
 }
 
@@ -643,6 +643,13 @@ struct Policy {
 
   std::vector<Statement> statements;
 
+  // statements that can apply to each action, in document order, so that
+  // eval() only visits the statements naming the action it is asked about.
+  // the indices of action a are action_statements[action_offsets[a] ..
+  // action_offsets[a + 1]). built once the policy is parsed
+  std::vector<std::uint32_t> action_offsets;
+  std::vector<std::uint32_t> action_statements;
+
   // reject_invalid_principals should be set to
   // `cct->_conf.get_val<bool>("rgw_policy_reject_invalid_principals")`
   // when executing operations that *set* a bucket policy, but should
@@ -661,6 +668,9 @@ struct Policy {
 
   Effect eval_conditions(const Environment& e) const;
 
+  // (re)build the action index after the statements change
+  void compile();
+
   template <typename F>
   bool has_conditional(const std::string& conditional, F p) const {
     for (const auto&s: statements){
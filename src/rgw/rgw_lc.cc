@@ -858,12 +858,18 @@ class LCOpRule {
   boost::optional<std::string> next_key_name;
   uint64_t num_noncurrent;
   ceph::real_time effective_mtime;
+  std::string prefix; // the rule's own prefix, within the listed prefix
 
   std::vector<shared_ptr<LCOpFilter> > filters; // n.b., sharing ovhd
   std::vector<shared_ptr<LCOpAction> > actions;
 
 public:
-  LCOpRule(op_env& _env) : env(_env) {}
+  LCOpRule(op_env& _env, const std::string& _prefix)
+    : env(_env), prefix(_prefix) {}
+
+  bool matches(const std::string& name) const {
+    return name.compare(0, prefix.size(), prefix) == 0;
+  }
 
   bool needs_tags() const {
     return env.op.obj_tags != boost::none;
@@ -1995,35 +2001,21 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
     grouped_ops[prefix_entry.first].push_back(&prefix_entry.second);
   }
 
-  rgw_obj_key pre_marker;
-  rgw_obj_key next_marker;
-  for (auto prefix_iter = grouped_ops.begin(); prefix_iter != grouped_ops.end();
-       ++prefix_iter) {
-
-    if (worker_should_stop(stop_at, once)) {
-      ldpp_dout(this, 5) << __func__ << " interval budget EXPIRED worker="
-		     << worker->ix << " bucket=" << bucket_name
-		     << dendl;
-      return 0;
-    }
-
-    ldpp_dout(this, 20) << __func__ << "(): prefix=" << prefix_iter->first
-			<< dendl;
-    if (prefix_iter != grouped_ops.begin() &&
-        (prefix_iter->first.compare(0, prev(prefix_iter)->first.length(),
-                                    prev(prefix_iter)->first) == 0)) {
-      next_marker = pre_marker;
-    } else {
-      pre_marker = next_marker;
-    }
-
-    LCObjsLister ol(driver, bucket.get());
-    ol.set_prefix(prefix_iter->first);
-
-    std::vector<lc_op*> active_ops;
-    active_ops.reserve(prefix_iter->second.size());
-
-    for (auto* op : prefix_iter->second) {
+  /*
+   * Rules whose prefixes nest share a single listing pass under the
+   * outermost prefix, instead of listing the overlapping keys once per
+   * prefix; each rule then only sees the entries matching its own
+   * prefix. grouped_ops is sorted, so the prefixes extending a given
+   * prefix directly follow it.
+   */
+  struct list_pass {
+    std::string prefix;
+    std::vector<std::pair<std::string, lc_op*>> ops; // rule prefix, op
+  };
+  std::vector<list_pass> passes;
+  for (auto& [prefix, ops] : grouped_ops) {
+    std::vector<std::pair<std::string, lc_op*>> active_ops;
+    for (auto* op : ops) {
       if (!is_valid_op(*op)) {
         continue;
       }
@@ -2032,11 +2024,36 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
                            << " zone, skipping" << dendl;
         continue;
       }
-      active_ops.push_back(op);
+      active_ops.emplace_back(prefix, op);
     }
     if (active_ops.empty()) {
       continue;
     }
+    if (passes.empty() ||
+        prefix.compare(0, passes.back().prefix.size(), passes.back().prefix) != 0) {
+      passes.push_back({prefix, {}});
+    }
+    auto& pass_ops = passes.back().ops;
+    pass_ops.insert(pass_ops.end(), active_ops.begin(), active_ops.end());
+  }
+
+  for (auto& pass : passes) {
+
+    if (worker_should_stop(stop_at, once)) {
+      ldpp_dout(this, 5) << __func__ << " interval budget EXPIRED worker="
+		     << worker->ix << " bucket=" << bucket_name
+		     << dendl;
+      return 0;
+    }
+
+    ldpp_dout(this, 20) << __func__ << "(): prefix=" << pass.prefix
+			<< " rules=" << pass.ops.size() << dendl;
+    if (perf_counters) {
+      perf_counters->inc(l_rgw_lc_per_bucket_list_passes);
+    }
+
+    LCObjsLister ol(driver, bucket.get());
+    ol.set_prefix(pass.prefix);
 
     ret = ol.init(this, yield);
     if (ret < 0) {
@@ -2047,10 +2064,10 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
     }
 
     std::vector<LCOpRule> rules;
-    rules.reserve(active_ops.size());
-    for (auto* op : active_ops) {
+    rules.reserve(pass.ops.size());
+    for (auto& [rule_prefix, op] : pass.ops) {
       op_env oenv(*op, driver, worker, bucket.get(), ol);
-      rules.emplace_back(oenv);
+      rules.emplace_back(oenv, rule_prefix);
       rules.back().build(); // why can't ctor do it?
     }
 
@@ -2212,12 +2229,23 @@ int RGWLC::bucket_lc_process(string& shard_id, LCWorker* worker,
               || key_group.size() >= 1000))
         flush_key_group();
 
-      key_group.push_back({obj, rules});
-
       total_objects_scanned++;
 
       batch_counters.increment_scanned();
 
+      std::vector<LCOpRule> matched;
+      for (const auto& rule : rules) {
+        if (rule.matches(obj.key.name)) {
+          matched.push_back(rule);
+        }
+      }
+      if (matched.empty()) {
+        // only under the pass prefix, not any rule's; nothing to spawn
+        batch_counters.decrement_pending();
+      } else {
+        key_group.push_back({obj, std::move(matched)});
+      }
+
       /*
        * Flush counters every batch_threshold objects.
        * Flush scanned first, then completed; obj_scanned is incremented
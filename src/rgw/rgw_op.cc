@@ -4940,7 +4940,7 @@ void RGWPutObj::execute(optional_yield y)
         ldpp_dout(this, 1) << "Cannot load plugin for compression type "
             << compression_type << dendl;
       } else {
-        compressor.emplace(s->cct, plugin, filter);
+        compressor.emplace(s->cct, plugin, filter, s->yield);
         filter = &*compressor;
         // always send incompressible hint when rgw is itself doing compression
         s->object->set_compressed();
@@ -4972,6 +4972,9 @@ void RGWPutObj::execute(optional_yield y)
 
     if (cksum_filter) {
       filter = &*cksum_filter;
+      if (need_calc_md5) {
+        cksum_filter->fuse_etag_hash(&hash);
+      }
     }
   } /* !append */
   tracepoint(rgw_op, before_data_transfer, s->req_id.c_str());
@@ -4998,8 +5001,8 @@ void RGWPutObj::execute(optional_yield y)
       break;
     }
 
-    if (need_calc_md5) {
-      hash.Update((const unsigned char *)data.c_str(), data.length());
+    if (need_calc_md5 && !(cksum_filter && cksum_filter->has_etag_hash())) {
+      rgw::putobj::hash_buffers(hash, data);
     }
 
     op_ret = filter->process(std::move(data), ofs);
@@ -5358,7 +5361,7 @@ void RGWPostObj::execute(optional_yield y)
           ldpp_dout(this, 1) << "Cannot load plugin for compression type "
                            << compression_type << dendl;
         } else {
-          compressor.emplace(s->cct, plugin, filter);
+          compressor.emplace(s->cct, plugin, filter, s->yield);
           filter = &*compressor;
         }
       }
@@ -5378,6 +5381,7 @@ void RGWPostObj::execute(optional_yield y)
     }
     if (cksum_filter) {
       filter = &*cksum_filter;
+      cksum_filter->fuse_etag_hash(&hash);
     }
 
     bool again;
@@ -5394,8 +5398,9 @@ void RGWPostObj::execute(optional_yield y)
         break;
       }
 
-      /* XXXX we should modernize to use component buffers? */
-      hash.Update((const unsigned char *)data.c_str(), data.length());
+      if (!(cksum_filter && cksum_filter->has_etag_hash())) {
+        rgw::putobj::hash_buffers(hash, data);
+      }
       op_ret = filter->process(std::move(data), ofs);
       if (op_ret < 0) {
         return;
@@ -6185,7 +6190,7 @@ public:
         ldpp_dout(s, 1) << "Cannot load plugin for compression type "
             << compression_type << dendl;
       } else {
-        compressor.emplace(s->cct, compressor_plugin, processor);
+        compressor.emplace(s->cct, compressor_plugin, processor, s->yield);
         processor = &*compressor;
         // always send incompressible hint when rgw is itself doing compression
         s->object->set_compressed();
@@ -8839,7 +8844,7 @@ int RGWBulkUploadOp::handle_file(const std::string_view path,
       ldpp_dout(this, 1) << "Cannot load plugin for rgw_compression_type "
           << compression_type << dendl;
     } else {
-      compressor.emplace(s->cct, plugin, filter);
+      compressor.emplace(s->cct, plugin, filter, s->yield);
       filter = &*compressor;
     }
   }
@@ -26,11 +26,20 @@ void add_rgw_frontend_counters(PerfCountersBuilder *pcb) {
 
   pcb->add_u64_counter(l_rgw_cache_hit, "cache_hit", "Cache hits");
   pcb->add_u64_counter(l_rgw_cache_miss, "cache_miss", "Cache miss");
+  pcb->add_u64_counter(l_rgw_cache_lock_contended, "cache_lock_contended",
+                       "Cache lookups that waited for a shard lock");
 
   pcb->add_u64_counter(l_rgw_keystone_token_cache_hit, "keystone_token_cache_hit", "Keystone token cache hits");
   pcb->add_u64_counter(l_rgw_keystone_token_cache_miss, "keystone_token_cache_miss", "Keystone token cache miss");
 
   pcb->add_u64_counter(l_rgw_gc_retire, "gc_retire_object", "GC object retires");
+  pcb->add_u64_counter(l_rgw_gc_tail_removed, "gc_tail_object", "GC tail objects removed");
+  pcb->add_time_avg(l_rgw_gc_shard_lat, "gc_shard_lat", "GC time spent processing a queue shard");
+
+  pcb->add_u64_counter(l_rgw_datalog_group_writes, "datalog_group_writes",
+                       "Grouped data log writes");
+  pcb->add_u64_avg(l_rgw_datalog_group_entries, "datalog_group_entries",
+                   "Data log entries per grouped write");
 
   pcb->add_u64_counter(l_rgw_lc_expire_current, "lc_expire_current",
 		      "Lifecycle current expiration");
@@ -63,6 +72,7 @@ void add_rgw_frontend_counters(PerfCountersBuilder *pcb) {
   pcb->add_u64_counter(l_rgw_d4n_cache_hits, "d4n_cache_hits", "D4N cache hits");
   pcb->add_u64_counter(l_rgw_d4n_cache_misses, "d4n_cache_misses", "D4N cache misses");
   pcb->add_u64_counter(l_rgw_d4n_cache_evictions, "d4n_cache_evictions", "D4N cache evictions");
+  pcb->add_u64_counter(l_rgw_d4n_cache_prefetches, "d4n_cache_prefetches", "D4N blocks prefetched for sequential reads");
 
   pcb->add_time_avg(l_rgw_kms_fetch_lat, "kms_fetch_lat", "Uncached KMS secret fetch latency");
   pcb->add_u64_counter(l_rgw_kms_error_permanent, "kms_error_permanent", "Permanent (e.g key not found) errors returned from KMS");
@@ -272,6 +282,9 @@ void add_lc_counters(PerfCountersBuilder *pcb) {
   pcb->add_u64_counter(l_rgw_lc_per_bucket_obj_mpu_aborted,
                        "objects_mpu_aborted",
                        "Multipart uploads aborted by LC");
+  pcb->add_u64_counter(l_rgw_lc_per_bucket_list_passes,
+                       "list_passes",
+                       "Bucket index listing passes made by LC");
 }
 
 std::shared_ptr<PerfCounters> create_lc_counters(const std::string& name, CephContext *cct) {
@@ -22,11 +22,17 @@ enum {
 
   l_rgw_cache_hit,
   l_rgw_cache_miss,
+  l_rgw_cache_lock_contended,
 
   l_rgw_keystone_token_cache_hit,
   l_rgw_keystone_token_cache_miss,
 
   l_rgw_gc_retire,
+  l_rgw_gc_tail_removed,
+  l_rgw_gc_shard_lat,
+
+  l_rgw_datalog_group_writes,
+  l_rgw_datalog_group_entries,
 
   l_rgw_lc_expire_current,
   l_rgw_lc_expire_noncurrent,
@@ -52,6 +58,7 @@ enum {
   l_rgw_d4n_cache_hits,
   l_rgw_d4n_cache_misses,
   l_rgw_d4n_cache_evictions,
+  l_rgw_d4n_cache_prefetches,
 
   l_rgw_kms_fetch_lat,
   l_rgw_kms_error_transient,
@@ -112,6 +119,7 @@ enum {
   l_rgw_lc_per_bucket_obj_dm_expired,
   l_rgw_lc_per_bucket_obj_transitioned,
   l_rgw_lc_per_bucket_obj_mpu_aborted,
+  l_rgw_lc_per_bucket_list_passes,
 
   l_rgw_lc_per_bucket_last
 };
@@ -15,8 +15,20 @@
 
 #include "rgw_putobj.h"
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
 namespace rgw::putobj {
 
+// worker threads shared by every ParallelProcessor in the process
+static boost::asio::thread_pool& get_worker_pool(CephContext* cct)
+{
+  static boost::asio::thread_pool pool(
+      std::max<uint64_t>(1, cct->_conf.get_val<uint64_t>(
+                                "rgw_put_obj_worker_threads")));
+  return pool;
+}
+
 int ChunkProcessor::process(bufferlist&& data, uint64_t offset)
 {
   ceph_assert(offset >= chunk.length());
@@ -96,4 +108,94 @@ int StripeProcessor::process(bufferlist&& data, uint64_t offset)
   return Pipe::process(std::move(data), offset - bounds.first);
 }
 
+ParallelProcessor::~ParallelProcessor()
+{
+  // results are dropped, but the workers still reference this
+  std::unique_lock lock{mutex};
+  while (!pending.empty()) {
+    wait_front(lock);
+    pending.pop_front();
+  }
+}
+
+void ParallelProcessor::wait_front(std::unique_lock<std::mutex>& lock)
+{
+  while (!pending.front()->done) {
+    if (y) {
+      boost::system::error_code ec;
+      waiter.async_wait(lock, y.get_yield_context()[ec]);
+    } else {
+      cond.wait(lock);
+    }
+  }
+}
+
+int ParallelProcessor::flush_pending(size_t remaining)
+{
+  std::unique_lock lock{mutex};
+  while (!pending.empty()) {
+    if (!pending.front()->done) {
+      if (pending.size() <= remaining) {
+        break;
+      }
+      wait_front(lock);
+    }
+    auto job = std::move(pending.front());
+    pending.pop_front();
+    lock.unlock();
+
+    if (job->result < 0) {
+      return job->result;
+    }
+    int r = Pipe::process(std::move(job->data), job->offset);
+    if (r < 0) {
+      return r;
+    }
+    lock.lock();
+  }
+  return 0;
+}
+
+int ParallelProcessor::process(bufferlist&& data, uint64_t offset)
+{
+  if (data.length() == 0) { // flush
+    int r = flush_pending(0);
+    if (r < 0) {
+      return r;
+    }
+    return Pipe::process({}, offset);
+  }
+
+  if (max_pending <= 1) {
+    int r = transform(data, offset);
+    if (r < 0) {
+      return r;
+    }
+    return Pipe::process(std::move(data), offset);
+  }
+
+  auto job = std::make_shared<Job>();
+  job->data = std::move(data);
+  job->offset = offset;
+  {
+    std::scoped_lock lock{mutex};
+    pending.push_back(job);
+  }
+  boost::asio::post(get_worker_pool(cct), [this, job] {
+      int r = transform(job->data, job->offset);
+      std::scoped_lock lock{mutex};
+      job->result = r;
+      job->done = true;
+      if (job == pending.front()) {
+        if (waiter) {
+          waiter.complete(boost::system::error_code{});
+        }
+        cond.notify_all();
+      }
+    });
+
+  // pass on whatever is already done, and bound the number in flight
+  return flush_pending(max_pending - 1);
+}
+
 } // namespace rgw::putobj
@@ -15,7 +15,14 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
 #include "include/buffer.h"
+#include "common/async/yield_waiter.h"
 #include "rgw_sal.h"
 
 namespace rgw::putobj {
@@ -70,4 +77,49 @@ class StripeProcessor : public Pipe {
   int process(bufferlist&& data, uint64_t data_offset) override;
 };
 
+// pipe that runs a transform over each buffer on a shared pool of worker
+// threads, with up to max_pending buffers in flight, and passes the
+// results on to the next processor in their original order. the
+// transform may only depend on the buffer and its offset; state that
+// depends on earlier buffers belongs in the next processor. with
+// max_pending <= 1, buffers are transformed inline
+class ParallelProcessor : public Pipe {
+ public:
+  using Transform = std::function<int(bufferlist& data, uint64_t offset)>;
+
+  ParallelProcessor(CephContext* cct, rgw::sal::DataProcessor *next,
+                    Transform transform, size_t max_pending,
+                    optional_yield y)
+    : Pipe(next), cct(cct), transform(std::move(transform)),
+      max_pending(max_pending), y(y)
+  {}
+  // waits for any transforms still running
+  virtual ~ParallelProcessor() override;
+
+  int process(bufferlist&& data, uint64_t offset) override;
+
+ private:
+  struct Job {
+    bufferlist data;
+    uint64_t offset = 0;
+    int result = 0;
+    bool done = false;
+  };
+  CephContext* cct;
+  const Transform transform;
+  const size_t max_pending;
+  optional_yield y;
+
+  std::mutex mutex;
+  std::condition_variable cond; // for waits without a yield context
+  ceph::async::yield_waiter<void> waiter;
+  std::deque<std::shared_ptr<Job>> pending; // in submission order
+
+  // wait for the oldest pending job to finish
+  void wait_front(std::unique_lock<std::mutex>& lock);
+  // pass on finished jobs in order, waiting until at most `remaining`
+  // are left in flight
+  int flush_pending(size_t remaining);
+};
+
 } // namespace rgw::putobj
@@ -28,6 +28,7 @@
 #include "rgw_sal_rados.h"
 #endif
 #include "rgw_quota.h"
+#include "rgw_quota_cache.h"
 #include "rgw_bucket.h"
 #include "driver/rados/rgw_user.h"
 
@@ -40,189 +41,6 @@
 
 using namespace std;
 
-struct RGWQuotaCacheStats {
-  RGWStorageStats stats;
-  utime_t expiration;
-  utime_t async_refresh_time;
-};
-
-template<class T>
-class RGWQuotaCache {
-protected:
-  rgw::sal::Driver* driver;
-  lru_map<T, RGWQuotaCacheStats> stats_map;
-  RefCountedWaitObject *async_refcount;
-
-  class StatsAsyncTestSet : public lru_map<T, RGWQuotaCacheStats>::UpdateContext {
-    int objs_delta;
-    uint64_t added_bytes;
-    uint64_t removed_bytes;
-  public:
-    StatsAsyncTestSet() : objs_delta(0), added_bytes(0), removed_bytes(0) {}
-    bool update(RGWQuotaCacheStats *entry) override {
-      if (entry->async_refresh_time.sec() == 0)
-        return false;
-
-      entry->async_refresh_time = utime_t(0, 0);
-
-      return true;
-    }
-  };
-
-  virtual int fetch_stats_from_storage(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider *dpp) = 0;
-
-  virtual bool map_find(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) = 0;
-
-  virtual bool map_find_and_update(const rgw_owner& owner, const rgw_bucket& bucket, typename lru_map<T, RGWQuotaCacheStats>::UpdateContext *ctx) = 0;
-  virtual void map_add(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) = 0;
-
-  virtual void data_modified(const rgw_owner& owner, const rgw_bucket& bucket) {}
-public:
-  RGWQuotaCache(rgw::sal::Driver* _driver, int size) : driver(_driver), stats_map(size) {
-    async_refcount = new RefCountedWaitObject;
-  }
-  virtual ~RGWQuotaCache() {
-    async_refcount->put_wait(); /* wait for all pending async requests to complete */
-  }
-
-  int get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y,
-                const DoutPrefixProvider* dpp);
-  void adjust_stats(const rgw_owner& owner, rgw_bucket& bucket, int objs_delta, uint64_t added_bytes, uint64_t removed_bytes);
-
-  void set_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs, const RGWStorageStats& stats);
-  int async_refresh(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs);
-  void async_refresh_response(const rgw_owner& owner, rgw_bucket& bucket, const RGWStorageStats& stats);
-  void async_refresh_fail(const rgw_owner& owner, rgw_bucket& bucket);
-
-  /// start an async refresh that will eventually call async_refresh_response or
-  /// async_refresh_fail. hold a reference to the waiter until completion
-  virtual int init_refresh(const rgw_owner& owner, const rgw_bucket& bucket,
-                           boost::intrusive_ptr<RefCountedWaitObject> waiter) = 0;
-};
-
-template<class T>
-int RGWQuotaCache<T>::async_refresh(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs)
-{
-  /* protect against multiple updates */
-  StatsAsyncTestSet test_update;
-  if (!map_find_and_update(owner, bucket, &test_update)) {
-    /* most likely we just raced with another update */
-    return 0;
-  }
-
-  return init_refresh(owner, bucket, async_refcount);
-}
-
-template<class T>
-void RGWQuotaCache<T>::async_refresh_fail(const rgw_owner& owner, rgw_bucket& bucket)
-{
-  ldout(driver->ctx(), 20) << "async stats refresh response for bucket=" << bucket << dendl;
-}
-
-template<class T>
-void RGWQuotaCache<T>::async_refresh_response(const rgw_owner& owner, rgw_bucket& bucket, const RGWStorageStats& stats)
-{
-  ldout(driver->ctx(), 20) << "async stats refresh response for bucket=" << bucket << dendl;
-
-  RGWQuotaCacheStats qs;
-
-  map_find(owner, bucket, qs);
-
-  set_stats(owner, bucket, qs, stats);
-}
-
-template<class T>
-void RGWQuotaCache<T>::set_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs, const RGWStorageStats& stats)
-{
-  qs.stats = stats;
-  qs.expiration = ceph_clock_now();
-  qs.async_refresh_time = qs.expiration;
-  qs.expiration += driver->ctx()->_conf->rgw_bucket_quota_ttl;
-  qs.async_refresh_time += driver->ctx()->_conf->rgw_bucket_quota_ttl / 2;
-
-  map_add(owner, bucket, qs);
-}
-
-template<class T>
-int RGWQuotaCache<T>::get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider* dpp) {
-  RGWQuotaCacheStats qs;
-  utime_t now = ceph_clock_now();
-  if (map_find(owner, bucket, qs)) {
-    if (qs.async_refresh_time.sec() > 0 && now >= qs.async_refresh_time) {
-      int r = async_refresh(owner, bucket, qs);
-      if (r < 0) {
-        ldpp_dout(dpp, 0) << "ERROR: quota async refresh returned ret=" << r << dendl;
-
-        /* continue processing, might be a transient error, async refresh is just optimization */
-      }
-    }
-
-    if (qs.expiration > ceph_clock_now()) {
-      stats = qs.stats;
-      return 0;
-    }
-  }
-
-  int ret = fetch_stats_from_storage(owner, bucket, stats, y, dpp);
-  if (ret < 0 && ret != -ENOENT)
-    return ret;
-
-  set_stats(owner, bucket, qs, stats);
-
-  return 0;
-}
-
-
-template<class T>
-class RGWQuotaStatsUpdate : public lru_map<T, RGWQuotaCacheStats>::UpdateContext {
-  const int objs_delta;
-  const uint64_t added_bytes;
-  const uint64_t removed_bytes;
-public:
-  RGWQuotaStatsUpdate(const int objs_delta,
-                      const uint64_t added_bytes,
-                      const uint64_t removed_bytes)
-    : objs_delta(objs_delta),
-      added_bytes(added_bytes),
-      removed_bytes(removed_bytes) {
-  }
-
-  bool update(RGWQuotaCacheStats * const entry) override {
-    const uint64_t rounded_added = rgw_rounded_objsize(added_bytes);
-    const uint64_t rounded_removed = rgw_rounded_objsize(removed_bytes);
-
-    if (((int64_t)(entry->stats.size + added_bytes - removed_bytes)) >= 0) {
-      entry->stats.size += added_bytes - removed_bytes;
-    } else {
-      entry->stats.size = 0;
-    }
-
-    if (((int64_t)(entry->stats.size_rounded + rounded_added - rounded_removed)) >= 0) {
-      entry->stats.size_rounded += rounded_added - rounded_removed;
-    } else {
-      entry->stats.size_rounded = 0;
-    }
-
-    if (((int64_t)(entry->stats.num_objects + objs_delta)) >= 0) {
-      entry->stats.num_objects += objs_delta;
-    } else {
-      entry->stats.num_objects = 0;
-    }
-
-    return true;
-  }
-};
-
-
-template<class T>
-void RGWQuotaCache<T>::adjust_stats(const rgw_owner& owner, rgw_bucket& bucket, int objs_delta,
-                                 uint64_t added_bytes, uint64_t removed_bytes)
-{
-  RGWQuotaStatsUpdate<T> update(objs_delta, added_bytes, removed_bytes);
-  map_find_and_update(owner, bucket, &update);
-
-  data_modified(owner, bucket);
-}
 
 class RGWBucketStatsCache : public RGWQuotaCache<rgw_bucket> {
 protected:
@@ -241,7 +59,7 @@ protected:
   int fetch_stats_from_storage(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider *dpp) override;
 
 public:
-  explicit RGWBucketStatsCache(rgw::sal::Driver* _driver) : RGWQuotaCache<rgw_bucket>(_driver, _driver->ctx()->_conf->rgw_bucket_quota_cache_size) {
+  explicit RGWBucketStatsCache(rgw::sal::Driver* _driver) : RGWQuotaCache<rgw_bucket>(_driver->ctx(), _driver, _driver->ctx()->_conf->rgw_bucket_quota_cache_size) {
   }
 
   int init_refresh(const rgw_owner& owner, const rgw_bucket& bucket,
@@ -506,7 +324,7 @@ protected:
 
 public:
   RGWOwnerStatsCache(const DoutPrefixProvider *dpp, rgw::sal::Driver* _driver, bool quota_threads)
-    : RGWQuotaCache<rgw_owner>(_driver, _driver->ctx()->_conf->rgw_bucket_quota_cache_size), dpp(dpp)
+    : RGWQuotaCache<rgw_owner>(_driver->ctx(), _driver, _driver->ctx()->_conf->rgw_bucket_quota_cache_size), dpp(dpp)
   {
     if (quota_threads) {
       buckets_sync_thread = new BucketsSyncThread(driver->ctx(), this);
@@ -0,0 +1,255 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab ft=cpp
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * Copyright (C) 2013 Inktank, Inc
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+
+#include "include/utime.h"
+#include "common/ceph_context.h"
+#include "common/Clock.h" // for ceph_clock_now()
+#include "common/dout.h"
+#include "common/lru_map.h"
+#include "common/RefCountedObj.h"
+
+#include "rgw_common.h"
+
+struct RGWQuotaCacheStats {
+  RGWStorageStats stats;
+  utime_t expiration;
+  utime_t async_refresh_time;
+};
+
+template<class T>
+class RGWQuotaCache {
+protected:
+  CephContext* const cct;
+  rgw::sal::Driver* driver;
+  lru_map<T, RGWQuotaCacheStats> stats_map;
+  RefCountedWaitObject *async_refcount;
+
+  class StatsAsyncTestSet : public lru_map<T, RGWQuotaCacheStats>::UpdateContext {
+    int objs_delta;
+    uint64_t added_bytes;
+    uint64_t removed_bytes;
+  public:
+    StatsAsyncTestSet() : objs_delta(0), added_bytes(0), removed_bytes(0) {}
+    bool update(RGWQuotaCacheStats *entry) override {
+      if (entry->async_refresh_time.sec() == 0)
+        return false;
+
+      entry->async_refresh_time = utime_t(0, 0);
+
+      return true;
+    }
+  };
+
+  class StatsAsyncRearm : public lru_map<T, RGWQuotaCacheStats>::UpdateContext {
+    utime_t retry_time;
+  public:
+    /* back off for half a ttl, like a successful refresh, so that a failing
+     * backend isn't retried by every request */
+    explicit StatsAsyncRearm(CephContext *cct) : retry_time(ceph_clock_now()) {
+      retry_time += cct->_conf->rgw_bucket_quota_ttl / 2;
+    }
+    bool update(RGWQuotaCacheStats *entry) override {
+      if (entry->async_refresh_time.sec() != 0)
+        return false;
+
+      entry->async_refresh_time = retry_time;
+
+      return true;
+    }
+  };
+
+  virtual int fetch_stats_from_storage(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider *dpp) = 0;
+
+  virtual bool map_find(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) = 0;
+
+  virtual bool map_find_and_update(const rgw_owner& owner, const rgw_bucket& bucket, typename lru_map<T, RGWQuotaCacheStats>::UpdateContext *ctx) = 0;
+  virtual void map_add(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) = 0;
+
+  virtual void data_modified(const rgw_owner& owner, const rgw_bucket& bucket) {}
+public:
+  RGWQuotaCache(CephContext* _cct, rgw::sal::Driver* _driver, int size)
+    : cct(_cct), driver(_driver), stats_map(size) {
+    async_refcount = new RefCountedWaitObject;
+  }
+  virtual ~RGWQuotaCache() {
+    async_refcount->put_wait(); /* wait for all pending async requests to complete */
+  }
+
+  int get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y,
+                const DoutPrefixProvider* dpp);
+  void adjust_stats(const rgw_owner& owner, rgw_bucket& bucket, int objs_delta, uint64_t added_bytes, uint64_t removed_bytes);
+
+  void set_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs, const RGWStorageStats& stats);
+  int async_refresh(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs);
+  void async_refresh_response(const rgw_owner& owner, rgw_bucket& bucket, const RGWStorageStats& stats);
+  void async_refresh_fail(const rgw_owner& owner, rgw_bucket& bucket);
+
+  /// start an async refresh that will eventually call async_refresh_response or
+  /// async_refresh_fail. hold a reference to the waiter until completion
+  virtual int init_refresh(const rgw_owner& owner, const rgw_bucket& bucket,
+                           boost::intrusive_ptr<RefCountedWaitObject> waiter) = 0;
+};
+
+template<class T>
+int RGWQuotaCache<T>::async_refresh(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs)
+{
+  /* protect against multiple updates */
+  StatsAsyncTestSet test_update;
+  if (!map_find_and_update(owner, bucket, &test_update)) {
+    /* most likely we just raced with another update */
+    return 0;
+  }
+
+  int r = init_refresh(owner, bucket, async_refcount);
+  if (r < 0) {
+    StatsAsyncRearm rearm(cct);
+    map_find_and_update(owner, bucket, &rearm);
+  }
+  return r;
+}
+
+template<class T>
+void RGWQuotaCache<T>::async_refresh_fail(const rgw_owner& owner, rgw_bucket& bucket)
+{
+  lsubdout(cct, rgw, 20) << "async stats refresh failed for bucket=" << bucket << dendl;
+
+  /* let a later request retry the async refresh, otherwise the entry would
+   * only be refreshed by a synchronous fetch once it expires */
+  StatsAsyncRearm rearm(cct);
+  map_find_and_update(owner, bucket, &rearm);
+}
+
+template<class T>
+void RGWQuotaCache<T>::async_refresh_response(const rgw_owner& owner, rgw_bucket& bucket, const RGWStorageStats& stats)
+{
+  lsubdout(cct, rgw, 20) << "async stats refresh response for bucket=" << bucket << dendl;
+
+  RGWQuotaCacheStats qs;
+
+  map_find(owner, bucket, qs);
+
+  set_stats(owner, bucket, qs, stats);
+}
+
+template<class T>
+void RGWQuotaCache<T>::set_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs, const RGWStorageStats& stats)
+{
+  qs.stats = stats;
+  qs.expiration = ceph_clock_now();
+  qs.async_refresh_time = qs.expiration;
+  qs.expiration += cct->_conf->rgw_bucket_quota_ttl;
+  qs.async_refresh_time += cct->_conf->rgw_bucket_quota_ttl / 2;
+
+  map_add(owner, bucket, qs);
+}
+
+template<class T>
+int RGWQuotaCache<T>::get_stats(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider* dpp) {
+  RGWQuotaCacheStats qs;
+  utime_t now = ceph_clock_now();
+  if (map_find(owner, bucket, qs)) {
+    if (qs.async_refresh_time.sec() > 0 && now >= qs.async_refresh_time) {
+      int r = async_refresh(owner, bucket, qs);
+      if (r < 0) {
+        ldpp_subdout(dpp, rgw, 0) << "ERROR: quota async refresh returned ret=" << r << dendl;
+
+        /* continue processing, might be a transient error, async refresh is just optimization */
+      } else {
+        /* async_refresh() cleared async_refresh_time in the map, either we
+         * started the refresh or another request just did */
+        qs.async_refresh_time = utime_t(0, 0);
+      }
+    }
+
+    if (qs.expiration > now) {
+      stats = qs.stats;
+      return 0;
+    }
+
+    /* if enabled, keep serving the cached stats, which adjust_stats() keeps
+     * current with our own writes, while an async refresh is in flight
+     * instead of having every request read them from storage */
+    utime_t stale_limit = qs.expiration;
+    stale_limit += cct->_conf->rgw_bucket_quota_stale_ttl;
+    if (qs.async_refresh_time.sec() == 0 && stale_limit > now) {
+      stats = qs.stats;
+      return 0;
+    }
+  }
+
+  int ret = fetch_stats_from_storage(owner, bucket, stats, y, dpp);
+  if (ret < 0 && ret != -ENOENT)
+    return ret;
+
+  set_stats(owner, bucket, qs, stats);
+
+  return 0;
+}
+
+
+template<class T>
+class RGWQuotaStatsUpdate : public lru_map<T, RGWQuotaCacheStats>::UpdateContext {
+  const int objs_delta;
+  const uint64_t added_bytes;
+  const uint64_t removed_bytes;
+public:
+  RGWQuotaStatsUpdate(const int objs_delta,
+                      const uint64_t added_bytes,
+                      const uint64_t removed_bytes)
+    : objs_delta(objs_delta),
+      added_bytes(added_bytes),
+      removed_bytes(removed_bytes) {
+  }
+
+  bool update(RGWQuotaCacheStats * const entry) override {
+    const uint64_t rounded_added = rgw_rounded_objsize(added_bytes);
+    const uint64_t rounded_removed = rgw_rounded_objsize(removed_bytes);
+
+    if (((int64_t)(entry->stats.size + added_bytes - removed_bytes)) >= 0) {
+      entry->stats.size += added_bytes - removed_bytes;
+    } else {
+      entry->stats.size = 0;
+    }
+
+    if (((int64_t)(entry->stats.size_rounded + rounded_added - rounded_removed)) >= 0) {
+      entry->stats.size_rounded += rounded_added - rounded_removed;
+    } else {
+      entry->stats.size_rounded = 0;
+    }
+
+    if (((int64_t)(entry->stats.num_objects + objs_delta)) >= 0) {
+      entry->stats.num_objects += objs_delta;
+    } else {
+      entry->stats.num_objects = 0;
+    }
+
+    return true;
+  }
+};
+
+
+template<class T>
+void RGWQuotaCache<T>::adjust_stats(const rgw_owner& owner, rgw_bucket& bucket, int objs_delta,
+                                 uint64_t added_bytes, uint64_t removed_bytes)
+{
+  RGWQuotaStatsUpdate<T> update(objs_delta, added_bytes, removed_bytes);
+  map_find_and_update(owner, bucket, &update);
+
+  data_modified(owner, bucket);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <chrono>
 #include <shared_mutex> // for std::shared_lock
 #include <thread>
@@ -241,11 +242,18 @@ private:
 class RateLimiter : public DoutPrefix {
 
   static constexpr size_t map_size = 2000000; // will create it with the closest upper prime number
-  std::shared_mutex insert_lock;
+  // entries are spread over independently locked shards, so inserting a new
+  // user or bucket only blocks the lookups that hash to the same shard
+  static constexpr size_t num_shards = 64;
   std::atomic_bool& replacing;
   std::condition_variable& cv;
   typedef std::unordered_map<std::string, RateLimiterEntry> hash_map;
-  hash_map ratelimit_entries{map_size};
+  struct shard {
+    std::shared_mutex insert_lock;
+    hash_map entries{map_size / num_shards};
+  };
+  std::array<shard, num_shards> shards;
+  std::atomic_size_t num_entries = 0;
 
   static inline constexpr std::string_view RESOURCE_PATTERN_LIST_TYPE = "list-type=";
   static inline constexpr std::string_view RESOURCE_PATTERN_PREFIX = "prefix=";
@@ -273,22 +281,33 @@ class RateLimiter : public DoutPrefix {
     return OpType::Write;
   }
 
-    // find or create an entry, and return its iterator
-  auto& find_or_create(const std::string& key) {
-    std::shared_lock rlock(insert_lock);
-    if (ratelimit_entries.size() > 0.9 * map_size && replacing == false)
+  shard& get_shard(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % num_shards];
+  }
+
+  // find or create an entry, and return a reference to it
+  RateLimiterEntry& find_or_create(const std::string& key) {
+    if (num_entries > 0.9 * map_size && replacing == false)
     {
       replacing = true;
       cv.notify_all();
     }
-    auto ret = ratelimit_entries.find(key);
-    rlock.unlock();
-    if (ret == ratelimit_entries.end())
+    auto& s = get_shard(key);
     {
-      std::unique_lock wlock(insert_lock);
-      ret = ratelimit_entries.emplace(std::piecewise_construct,
-                                 std::forward_as_tuple(key),
-                                 std::forward_as_tuple()).first;
+      std::shared_lock rlock(s.insert_lock);
+      auto ret = s.entries.find(key);
+      if (ret != s.entries.end())
+      {
+        return ret->second;
+      }
+    }
+    std::unique_lock wlock(s.insert_lock);
+    auto [ret, inserted] = s.entries.emplace(std::piecewise_construct,
+                                             std::forward_as_tuple(key),
+                                             std::forward_as_tuple());
+    if (inserted)
+    {
+      ++num_entries;
     }
     return ret->second;
   }
@@ -305,7 +324,9 @@ class RateLimiter : public DoutPrefix {
       : DoutPrefix(cct, ceph_subsys_rgw, "rate limiter: "), replacing(replacing), cv(cv)
     {
       // prevents rehash, so no iterators invalidation
-      ratelimit_entries.max_load_factor(1000);
+      for (auto& s : shards) {
+        s.entries.max_load_factor(1000);
+      }
     };
 
     // Returns 0 if allowed, or the retry delay in seconds if rate-limited.
@@ -345,7 +366,11 @@ class RateLimiter : public DoutPrefix {
       // OpType::List does not affect bytes
     }
     void clear() {
-      ratelimit_entries.clear();
+      for (auto& s : shards) {
+        std::unique_lock wlock(s.insert_lock);
+        s.entries.clear();
+      }
+      num_entries = 0;
     }
 };
 // This class purpose is to hold 2 RateLimiter instances, one active and one passive.
@@ -6611,7 +6611,8 @@ gen_v4_signature(const DoutPrefixProvider *dpp,
                  const std::string_view& secret_key,
                  const AWSSignerV4::prepare_result_t& sig_info)
 {
-  auto signature = rgw::auth::s3::get_v4_signature(sig_info.scope,
+  auto signature = rgw::auth::s3::get_v4_signature(sig_info.access_key_id,
+                                                   sig_info.scope,
                                                    dpp->get_cct(),
                                                    secret_key,
                                                    sig_info.string_to_sign,
@@ -6713,6 +6714,7 @@ AWSGeneralAbstractor::get_auth_data_v4(const req_state* const s,
                                          s);
 
   const auto sig_factory = std::bind(rgw::auth::s3::get_v4_signature,
+                                     access_key_id,
                                      credential_scope,
                                      std::placeholders::_1,
                                      std::placeholders::_2,
@@ -6877,6 +6879,7 @@ AWSGeneralAbstractor::get_auth_data_v4(const req_state* const s,
       const auto cmpl_factory = std::bind(AWSv4ComplMulti::create,
                                           s,
                                           date,
+                                          access_key_id,
                                           credential_scope,
                                           client_signature,
 					  flags,
@@ -7016,6 +7019,7 @@ AWSBrowserUploadAbstractor::get_auth_data_v4(const req_state* const s) const
   ldpp_dout(s, 10) << "credential scope = " << credential_scope << dendl;
 
   const auto sig_factory = std::bind(rgw::auth::s3::get_v4_signature,
+                                     access_key_id,
                                      credential_scope,
                                      std::placeholders::_1,
                                      std::placeholders::_2,
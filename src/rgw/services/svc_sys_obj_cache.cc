@@ -544,7 +544,9 @@ class RGWSI_SysObj_Cache_ASocketHook : public AdminSocketHook {
     { "cache erase name=target,type=CephString,req=true",
       "cache erase target: erase element from cache" },
     { "cache zap",
-      "cache zap: erase all elements from cache" }
+      "cache zap: erase all elements from cache" },
+    { "cache stats",
+      "cache stats: dump per-shard cache hit and lock contention counts" }
   };
 
 public:
@@ -615,6 +617,9 @@ int RGWSI_SysObj_Cache_ASocketHook::call(
   } else if (command == "cache zap"sv) {
     svc->asocket.call_zap();
     return 0;
+  } else if (command == "cache stats"sv) {
+    svc->asocket.call_stats(f);
+    return 0;
   }
   return -ENOSYS;
 }
@@ -672,3 +677,10 @@ int RGWSI_SysObj_Cache::ASocketHandler::call_zap()
   svc->cache.invalidate_all();
   return 0;
 }
+
+void RGWSI_SysObj_Cache::ASocketHandler::call_stats(Formatter* f)
+{
+  f->open_object_section("cache_stats");
+  svc->cache.dump_stats(f);
+  f->close_section();
+}
@@ -143,6 +143,9 @@ public:
 
     // `call_zap` must erase the cache.
     int call_zap();
+
+    // `call_stats` dumps the per-shard counters of the cache.
+    void call_stats(Formatter* f);
   } asocket;
 };
 
@@ -0,0 +1,127 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "common/ceph_argparse.h"
+#include "common/hobject.h"
+#include "global/global_context.h"
+#include "global/global_init.h"
+#include "include/buffer.h"
+#include "include/denc.h"
+#include "include/encoding.h"
+#include "osd/osd_types.h"
+
+// Encode/decode cost of small, hot types; each iteration encodes (or
+// decodes) a single object into a fresh bufferlist.
+
+namespace {
+
+hobject_t make_hobject() {
+  return hobject_t(object_t("rbd_data.1234567890ab.0000000000000042"),
+		   "", CEPH_NOSNAP, 0x2a5d17c3, 3, "");
+}
+
+pg_log_entry_t make_log_entry() {
+  return pg_log_entry_t(pg_log_entry_t::MODIFY, make_hobject(),
+			eversion_t(12, 3456), eversion_t(12, 3455), 7,
+			osd_reqid_t(entity_name_t::CLIENT(4242), 0, 1234),
+			utime_t(1700000000, 0), 0);
+}
+
+void BM_EncodeOmapKey(benchmark::State& state) {
+  const std::string key = "0000000012.00000000000000003456";
+  for (auto _ : state) {
+    ceph::buffer::list bl;
+    encode(key, bl);
+    benchmark::DoNotOptimize(bl);
+  }
+}
+BENCHMARK(BM_EncodeOmapKey);
+
+void BM_EncodeHobject(benchmark::State& state) {
+  const hobject_t hoid = make_hobject();
+  for (auto _ : state) {
+    ceph::buffer::list bl;
+    encode(hoid, bl);
+    benchmark::DoNotOptimize(bl);
+  }
+}
+BENCHMARK(BM_EncodeHobject);
+
+void BM_DecodeHobject(benchmark::State& state) {
+  ceph::buffer::list bl;
+  encode(make_hobject(), bl);
+  for (auto _ : state) {
+    hobject_t hoid;
+    auto p = bl.cbegin();
+    decode(hoid, p);
+    benchmark::DoNotOptimize(hoid);
+  }
+}
+BENCHMARK(BM_DecodeHobject);
+
+void BM_EncodePgLogEntry(benchmark::State& state) {
+  const pg_log_entry_t e = make_log_entry();
+  for (auto _ : state) {
+    ceph::buffer::list bl;
+    e.encode_with_checksum(bl);
+    benchmark::DoNotOptimize(bl);
+  }
+}
+BENCHMARK(BM_EncodePgLogEntry);
+
+void BM_DecodePgLogEntry(benchmark::State& state) {
+  ceph::buffer::list bl;
+  make_log_entry().encode_with_checksum(bl);
+  for (auto _ : state) {
+    pg_log_entry_t e;
+    auto p = bl.cbegin();
+    e.decode_with_checksum(p);
+    benchmark::DoNotOptimize(e);
+  }
+}
+BENCHMARK(BM_DecodePgLogEntry);
+
+// a list assembled from many small ptrs, as messages and transactions do
+// when they splice in caller-provided buffers; dominated by ptr_node
+// allocation.
+void BM_AppendSmallPtrs(benchmark::State& state) {
+  const auto count = state.range(0);
+  ceph::buffer::ptr bp(ceph::buffer::create(64));
+  for (auto _ : state) {
+    ceph::buffer::list bl;
+    for (int64_t i = 0; i < count; ++i) {
+      bl.push_back(ceph::buffer::ptr(bp, i % 64, 1));
+    }
+    benchmark::DoNotOptimize(bl);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AppendSmallPtrs)->Arg(8)->Arg(64)->Arg(512);
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+  auto args = argv_to_vec(argc, argv);
+  auto cct = global_init(
+      nullptr, args, CEPH_ENTITY_TYPE_CLIENT, CODE_ENVIRONMENT_UTILITY,
+      CINIT_FLAG_NO_MON_CONFIG);
+  common_init_finish(g_ceph_context);
+
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include <sys/uio.h>
 
 #include <iostream> // for std::cout
+#include <thread>
 
 #include "include/buffer.h"
 #include "include/buffer_raw.h"
@@ -2103,6 +2104,43 @@ TEST(BufferList, rebuild_page_aligned) {
   }
 }
 
+TEST(BufferList, ptr_node_pool) {
+  if (get_env_bool("CEPH_BUFFER_NO_PTR_NODE_POOL")) {
+    GTEST_SKIP() << "ptr_node pool disabled";
+  }
+  bufferptr bp(buffer::create(16));
+  memset(bp.c_str(), 'x', bp.length());
+  {
+    bufferlist bl;
+    for (unsigned i = 0; i < 64; ++i) {
+      bl.push_back(bufferptr(bp, i % 16, 1));
+    }
+    EXPECT_EQ(64u, bl.get_num_buffers());
+  }
+  // the nodes released above are reused by the next list on this thread
+  const uint64_t hits = buffer::get_ptr_node_pool_hits();
+  {
+    bufferlist bl;
+    for (unsigned i = 0; i < 64; ++i) {
+      bl.push_back(bufferptr(bp, i % 16, 1));
+    }
+    EXPECT_EQ(64u, bl.length());
+    EXPECT_EQ(std::string(64, 'x'), bl.to_str());
+    bufferlist copy(bl);
+    EXPECT_TRUE(copy.contents_equal(bl));
+  }
+  EXPECT_LE(hits + 64, buffer::get_ptr_node_pool_hits());
+  // nodes may be freed on a different thread than the one that made them
+  bufferlist moved;
+  for (unsigned i = 0; i < 64; ++i) {
+    moved.push_back(bufferptr(bp, 0, 1));
+  }
+  std::thread([bl = std::move(moved)]() mutable {
+    EXPECT_EQ(64u, bl.length());
+    bl.clear();
+  }).join();
+}
+
 TEST(BufferList, claim_append) {
   bufferlist from;
   {
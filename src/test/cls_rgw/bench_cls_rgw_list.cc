@@ -0,0 +1,209 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Benchmark for delimited listings of a single bucket index shard.
+ *
+ * Fills one index object in a temporary pool with a tree of keys and
+ * times complete listings through the cls_rgw bucket_list method:
+ *
+ *   ceph_bench_cls_rgw_list [--keys N] [--dirs N] [--subdirs N] [--max N]
+ *
+ * The keys are spread over <dirs> top-level subdirectories, each holding
+ * <subdirs> nested subdirectories, plus one top-level object per
+ * subdirectory.
+ */
+
+#include "cls/rgw/cls_rgw_client.h"
+#include "cls/rgw/cls_rgw_const.h"
+#include "cls/rgw/cls_rgw_ops.h"
+#include "common/errno.h"
+#include "test/librados/test_cxx.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+using namespace librados;
+
+namespace {
+
+struct Options {
+  uint64_t keys = 1000000;
+  uint32_t dirs = 1000;
+  uint32_t subdirs = 10;
+  uint32_t max = 1000;
+};
+
+int put_batch(IoCtx& ioctx, const std::string& oid,
+              std::vector<rgw_cls_bi_entry>& batch)
+{
+  ObjectWriteOperation op;
+  cls_rgw_bi_put_entries(op, std::move(batch), false);
+  batch.clear();
+  return ioctx.operate(oid, &op);
+}
+
+int fill(IoCtx& ioctx, const std::string& oid, const Options& o)
+{
+  ObjectWriteOperation op;
+  cls_rgw_bucket_init_index(op);
+  int r = ioctx.operate(oid, &op);
+  if (r < 0) {
+    return r;
+  }
+
+  constexpr size_t batch_size = 1000;
+  std::vector<rgw_cls_bi_entry> batch;
+  batch.reserve(batch_size);
+
+  auto add = [&] (std::string name) {
+    rgw_bucket_dir_entry entry;
+    entry.key.name = name;
+    entry.exists = true;
+    entry.meta.category = RGWObjCategory::Main;
+    entry.meta.size = 4096;
+    entry.meta.accounted_size = 4096;
+
+    rgw_cls_bi_entry bi;
+    bi.type = BIIndexType::Plain;
+    bi.idx = std::move(name);
+    encode(entry, bi.data);
+    batch.push_back(std::move(bi));
+    return batch.size() < batch_size ? 0 : put_batch(ioctx, oid, batch);
+  };
+
+  const uint64_t per_dir = std::max<uint64_t>(1, o.keys / o.dirs);
+  for (uint32_t d = 0; d < o.dirs; ++d) {
+    r = add(fmt::format("obj{:06}", d));
+    if (r < 0) {
+      return r;
+    }
+    for (uint64_t k = 0; k < per_dir; ++k) {
+      r = add(fmt::format("dir{:06}/sub{:04}/obj{:09}", d, k % o.subdirs, k));
+      if (r < 0) {
+        return r;
+      }
+    }
+  }
+  return batch.empty() ? 0 : put_batch(ioctx, oid, batch);
+}
+
+// list to the end, returning the number of entries and cls calls
+int list_all(IoCtx& ioctx, const std::string& oid, const std::string& prefix,
+             const std::string& delimiter, uint32_t max,
+             uint64_t& entries, uint64_t& calls)
+{
+  cls_rgw_obj_key marker;
+  entries = 0;
+  calls = 0;
+  for (;;) {
+    rgw_cls_list_ret result;
+    ObjectReadOperation op;
+    cls_rgw_bucket_list_op(op, marker, prefix, delimiter, max, false, &result);
+    int r = ioctx.operate(oid, &op, nullptr);
+    ++calls;
+    if (r < 0 && r != RGWBIAdvanceAndRetryError) {
+      return r;
+    }
+    entries += result.dir.m.size();
+    if (!result.is_truncated) {
+      return 0;
+    }
+    if (!result.marker.empty()) {
+      marker = result.marker;
+    } else if (!result.dir.m.empty()) {
+      marker = result.dir.m.rbegin()->second.key;
+    } else {
+      return -EIO;
+    }
+  }
+}
+
+int run(IoCtx& ioctx, const std::string& oid, const std::string& name,
+        const std::string& prefix, const std::string& delimiter, uint32_t max)
+{
+  using namespace std::chrono;
+  uint64_t entries = 0, calls = 0;
+  const auto start = steady_clock::now();
+  int r = list_all(ioctx, oid, prefix, delimiter, max, entries, calls);
+  const auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+  if (r < 0) {
+    std::cerr << name << ": listing failed: " << cpp_strerror(-r) << std::endl;
+    return r;
+  }
+  std::cout << fmt::format("{:<24} {:>10} entries {:>8} calls {:>12} us {:>10.1f} us/call",
+                           name, entries, calls, elapsed.count(),
+                           double(elapsed.count()) / calls) << std::endl;
+  return 0;
+}
+
+void usage()
+{
+  std::cerr << "usage: ceph_bench_cls_rgw_list [--keys N] [--dirs N] "
+      "[--subdirs N] [--max N]" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  Options o;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 >= argc) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    const uint64_t val = std::strtoull(argv[i + 1], nullptr, 10);
+    if (std::strcmp(argv[i], "--keys") == 0) {
+      o.keys = val;
+    } else if (std::strcmp(argv[i], "--dirs") == 0) {
+      o.dirs = std::max<uint64_t>(1, val);
+    } else if (std::strcmp(argv[i], "--subdirs") == 0) {
+      o.subdirs = std::max<uint64_t>(1, val);
+    } else if (std::strcmp(argv[i], "--max") == 0) {
+      o.max = std::max<uint64_t>(1, val);
+    } else {
+      usage();
+      return EXIT_FAILURE;
+    }
+    ++i;
+  }
+
+  Rados rados;
+  const std::string pool_name = get_temp_pool_name();
+  std::string err = create_one_pool_pp(pool_name, rados);
+  if (!err.empty()) {
+    std::cerr << "failed to create pool: " << err << std::endl;
+    return EXIT_FAILURE;
+  }
+  IoCtx ioctx;
+  int r = rados.ioctx_create(pool_name.c_str(), ioctx);
+  const std::string oid = "bench_cls_rgw_list";
+  if (r == 0) {
+    std::cout << "filling " << o.keys << " keys in " << o.dirs
+        << " directories..." << std::endl;
+    r = fill(ioctx, oid, o);
+  }
+  if (r == 0) {
+    r = run(ioctx, oid, "delimited /", "", "/", o.max);
+  }
+  if (r == 0) {
+    r = run(ioctx, oid, "delimited dir000000/", "dir000000/", "/", o.max);
+  }
+  if (r == 0) {
+    r = run(ioctx, oid, "flat dir000000/", "dir000000/", "", o.max);
+  }
+  if (r < 0) {
+    std::cerr << "benchmark failed: " << cpp_strerror(-r) << std::endl;
+  }
+
+  ioctx.close();
+  destroy_one_pool_pp(pool_name, rados);
+  return r < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -562,18 +562,19 @@ TEST_F(cls_rgw, index_list_delimited)
   list_entries(ioctx, bucket_oid, 1000, listing, start_key, delimiter);
   auto id_entry_map = listing.dir.m;
 
-  // the cls code will make 4 tries to get 1000 entries; however
-  // because each of the subdirectories is so large, each attempt will
-  // only retrieve the first part of the subdirectory
+  // the first read of 1000 entries ends inside the large "b/"
+  // subdirectory; after that the cls code seeks past each
+  // subdirectory with small reads instead of reading 1000 entries
+  // of it, so a single call gets the whole listing
 
-  ASSERT_EQ(48u, id_entry_map.size()) <<
-    "We should get 40 top-level entries and the tops of 8 \"subdirectories\".";
-  ASSERT_EQ(true, listing.is_truncated) << "We did not get all entries.";
+  ASSERT_EQ(65u, id_entry_map.size()) <<
+    "We should get 55 top-level entries and the tops of 10 \"subdirectories\".";
+  ASSERT_EQ(false, listing.is_truncated) << "We should have all entries.";
 
   ASSERT_EQ("a-0", id_entry_map.cbegin()->first);
-  ASSERT_EQ("p/", id_entry_map.crbegin()->first);
+  ASSERT_EQ("u-4", id_entry_map.crbegin()->first);
 
-  // now let's get the rest of the entries
+  // listing again after a subdirectory gets the rest of the entries
 
   listing = {};
   cls_rgw_obj_key start_key2("p/", "");
@@ -589,6 +590,79 @@ TEST_F(cls_rgw, index_list_delimited)
 }
 
 
+TEST_F(cls_rgw, index_list_resume_key)
+{
+  string bucket_oid = str_int("resume", 0);
+
+  ObjectWriteOperation op;
+  cls_rgw_bucket_init_index(op);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, &op));
+
+  rgw_bucket_dir_entry_meta meta;
+  meta.category = RGWObjCategory::None;
+  meta.size = 1024;
+
+  const std::vector<std::string> objs =
+    { "a-0", "a-1", "b/f-0", "b/f-1", "b/f-2", "c-0" };
+  for (size_t i = 0; i < objs.size(); i++) {
+    string tag = str_int("tag", i);
+    string loc = str_int("loc", i);
+    index_prepare(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, objs[i], loc);
+    index_complete(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, 1, objs[i], meta,
+		   0 /* bi_flags */, false /* log_op */);
+  }
+
+  // read one entry at a time the way a shard refill does, resuming
+  // from the previous result each time
+  std::vector<std::string> names;
+  cls_rgw_obj_key start_key;
+  for (int calls = 0; calls < 10; calls++) {
+    rgw_cls_list_ret listing;
+    list_entries(ioctx, bucket_oid, 1, listing, start_key, "/");
+    for (const auto& [name, entry] : listing.dir.m) {
+      names.push_back(name);
+    }
+    if (!listing.is_truncated) {
+      break;
+    }
+    const auto next = cls_rgw_bucket_list_resume_key(listing, start_key);
+    ASSERT_LT(start_key, next);
+    start_key = next;
+  }
+  const std::vector<std::string> expected = { "a-0", "a-1", "b/", "c-0" };
+  EXPECT_EQ(expected, names);
+}
+
+TEST(cls_rgw_client, bucket_list_resume_key)
+{
+  const cls_rgw_obj_key start_after("a");
+
+  // nothing returned and no marker: stay where we were
+  rgw_cls_list_ret ret;
+  ret.is_truncated = true;
+  EXPECT_EQ(start_after, cls_rgw_bucket_list_resume_key(ret, start_after));
+
+  // nothing returned, but cls skipped ahead: follow its marker
+  ret.marker = cls_rgw_obj_key("m");
+  EXPECT_EQ(ret.marker, cls_rgw_bucket_list_resume_key(ret, start_after));
+
+  // the marker lies past the last entry
+  ret.dir.m["c"].key = cls_rgw_obj_key("c");
+  EXPECT_EQ(ret.marker, cls_rgw_bucket_list_resume_key(ret, start_after));
+
+  // without a marker, resume after the last entry
+  ret.marker = {};
+  EXPECT_EQ(cls_rgw_obj_key("c"),
+	    cls_rgw_bucket_list_resume_key(ret, start_after));
+
+  // and past everything beneath a trailing common prefix
+  auto& prefix = ret.dir.m["d/"];
+  prefix.key = cls_rgw_obj_key("d/");
+  prefix.flags = rgw_bucket_dir_entry::FLAG_COMMON_PREFIX;
+  EXPECT_EQ(cls_rgw_obj_key(cls_rgw_after_delim("d/")),
+	    cls_rgw_bucket_list_resume_key(ret, start_after));
+}
+
 TEST_F(cls_rgw, bi_list)
 {
   string bucket_oid = str_int("bucket", 5);
@@ -1543,6 +1617,60 @@ TEST_F(cls_rgw, reshardlog_num)
   reshardlog_entries(ioctx, bucket_oid, 2u);
 }
 
+TEST_F(cls_rgw, reshardlog_trim_entries)
+{
+  string bucket_oid = str_int("reshard3", 0);
+
+  ObjectWriteOperation op;
+  cls_rgw_bucket_init_index(op);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, &op));
+
+  set_reshard_status(ioctx, bucket_oid, cls_rgw_reshard_status::IN_LOGRECORD);
+
+  cls_rgw_obj_key obj1 = str_int("obj1", 0);
+  cls_rgw_obj_key obj2 = str_int("obj2", 0);
+  string tag = str_int("tag-prepare", 0);
+  string loc = str_int("loc", 0);
+  rgw_bucket_dir_entry_meta meta;
+  index_prepare(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, obj1, loc);
+  index_complete(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, 1, obj1, meta);
+  index_prepare(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, obj2, loc);
+  index_complete(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, 2, obj2, meta);
+  reshardlog_entries(ioctx, bucket_oid, 2u);
+
+  bool is_truncated = false;
+  std::list<rgw_cls_bi_entry> entries;
+  ASSERT_EQ(0, reshardlog_list(ioctx, bucket_oid, &entries, &is_truncated));
+  ASSERT_EQ(2u, entries.size());
+
+  // rewrite obj2's log record after it was listed
+  index_prepare(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, obj2, loc);
+  index_complete(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, 3, obj2, meta);
+  reshardlog_entries(ioctx, bucket_oid, 3u);
+
+  // only obj1's record is removed, obj2's newer record stays
+  {
+    ObjectWriteOperation op;
+    cls_rgw_bucket_reshard_log_trim_entries(op, {entries.begin(), entries.end()});
+    ASSERT_EQ(0, ioctx.operate(bucket_oid, &op));
+  }
+  entries.clear();
+  ASSERT_EQ(0, reshardlog_list(ioctx, bucket_oid, &entries, &is_truncated));
+  ASSERT_EQ(1u, entries.size());
+  reshardlog_entries(ioctx, bucket_oid, 2u);
+
+  // trimming the fresh listing empties the log and resets the count
+  {
+    ObjectWriteOperation op;
+    cls_rgw_bucket_reshard_log_trim_entries(op, {entries.begin(), entries.end()});
+    ASSERT_EQ(0, ioctx.operate(bucket_oid, &op));
+  }
+  entries.clear();
+  ASSERT_EQ(0, reshardlog_list(ioctx, bucket_oid, &entries, &is_truncated));
+  ASSERT_EQ(0u, entries.size());
+  reshardlog_entries(ioctx, bucket_oid, 0u);
+}
+
 TEST_F(cls_rgw, bi_put_entries)
 {
   const string src_bucket = str_int("bi_put_entries", 0);
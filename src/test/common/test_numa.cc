@@ -1,6 +1,12 @@
 // -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
 // vim: ts=8 sw=2 sts=2 expandtab
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <pthread.h>
+
 #include "gtest/gtest.h"
 #include "common/numa.h"
 
@@ -70,3 +76,39 @@ TEST(cpu_set, round_trip_list)
   }
 }
 
+
+#ifdef __linux__
+TEST(cpu_set, named_thread_affinity)
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(cpu_set), &cpu_set));
+
+  std::mutex lock;
+  std::condition_variable cond;
+  bool named = false, done = false;
+  std::thread t([&] {
+    pthread_setname_np(pthread_self(), "numa-test-thr");
+    std::unique_lock l(lock);
+    named = true;
+    cond.notify_all();
+    cond.wait(l, [&] { return done; });
+  });
+  {
+    std::unique_lock l(lock);
+    cond.wait(l, [&] { return named; });
+  }
+
+  EXPECT_EQ(1, set_cpu_affinity_named_threads({"numa-test"},
+					      sizeof(cpu_set), &cpu_set));
+  EXPECT_EQ(0, set_cpu_affinity_named_threads({"no-such-thread"},
+					      sizeof(cpu_set), &cpu_set));
+
+  {
+    std::lock_guard l(lock);
+    done = true;
+  }
+  cond.notify_all();
+  t.join();
+}
+#endif
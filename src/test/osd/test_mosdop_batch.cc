@@ -0,0 +1,69 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+#include "gtest/gtest.h"
+
+#include "include/ceph_features.h"
+#include "messages/MOSDOp.h"
+#include "messages/MOSDOpBatch.h"
+
+static ceph::ref_t<MOSDOp> make_op(ceph_tid_t tid, const std::string& oid)
+{
+  hobject_t hoid(object_t(oid), "", CEPH_NOSNAP, 0, 1, "");
+  spg_t pgid(pg_t(0, 1));
+  auto m = ceph::make_message<MOSDOp>(1, tid, hoid, pgid, 10, 0,
+				      CEPH_FEATURES_ALL);
+  return m;
+}
+
+TEST(MOSDOpBatch, RoundTrip)
+{
+  auto batch = ceph::make_message<MOSDOpBatch>();
+  auto w = make_op(1, "foo");
+  ceph::buffer::list bl;
+  bl.append("hello");
+  w->write(0, bl.length(), bl);
+  batch->ops.push_back(w);
+  auto r = make_op(2, "bar");
+  r->read(4096, 512);
+  batch->ops.push_back(r);
+
+  ceph::buffer::list enc;
+  encode_message(batch.get(), CEPH_FEATURES_ALL, enc);
+  auto p = enc.cbegin();
+  ceph::ref_t<Message> m(decode_message(nullptr, 0, p), false);
+  ASSERT_TRUE(m);
+  ASSERT_EQ(MSG_OSD_OP_BATCH, m->get_type());
+
+  auto decoded = ceph::ref_cast<MOSDOpBatch>(m);
+  ASSERT_EQ(2u, decoded->ops.size());
+
+  auto d0 = ceph::ref_cast<MOSDOp>(decoded->ops[0]);
+  d0->finish_decode();
+  EXPECT_EQ(1u, d0->get_tid());
+  EXPECT_EQ("foo", d0->get_oid().name);
+  ASSERT_EQ(1u, d0->ops.size());
+  EXPECT_EQ(CEPH_OSD_OP_WRITE, d0->ops[0].op.op);
+  EXPECT_EQ(5u, d0->ops[0].op.extent.length);
+  EXPECT_EQ(5u, d0->get_data().length());
+
+  auto d1 = ceph::ref_cast<MOSDOp>(decoded->ops[1]);
+  d1->finish_decode();
+  EXPECT_EQ(2u, d1->get_tid());
+  EXPECT_EQ("bar", d1->get_oid().name);
+  ASSERT_EQ(1u, d1->ops.size());
+  EXPECT_EQ(CEPH_OSD_OP_READ, d1->ops[0].op.op);
+  EXPECT_EQ(4096u, d1->ops[0].op.extent.offset);
+}
+
+TEST(MOSDOpBatch, RejectsOtherMessages)
+{
+  auto batch = ceph::make_message<MOSDOpBatch>();
+  batch->ops.push_back(ceph::make_message<MOSDOpBatch>());
+
+  ceph::buffer::list enc;
+  encode_message(batch.get(), CEPH_FEATURES_ALL, enc);
+  auto p = enc.cbegin();
+  // decode_message swallows the decode error and returns nullptr
+  EXPECT_EQ(nullptr, decode_message(nullptr, 0, p));
+}
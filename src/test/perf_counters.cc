@@ -268,6 +268,60 @@ TEST(PerfCounters, read_avg) {
   t1.join();
 }
 
+enum {
+  TEST_PERFCOUNTERS_SHARDED_FIRST = 500,
+  TEST_PERFCOUNTERS_SHARDED_COUNTER,
+  TEST_PERFCOUNTERS_SHARDED_AVG,
+  TEST_PERFCOUNTERS_SHARDED_GAUGE,
+  TEST_PERFCOUNTERS_SHARDED_LAST,
+};
+
+TEST(PerfCounters, Sharded) {
+  g_ceph_context->_conf.set_val_or_die("perf_counters_shards", "4");
+  PerfCountersBuilder bld(g_ceph_context, "test_perfcounter_sharded",
+      TEST_PERFCOUNTERS_SHARDED_FIRST, TEST_PERFCOUNTERS_SHARDED_LAST);
+  g_ceph_context->_conf.set_val_or_die("perf_counters_shards", "0");
+  bld.set_sharded(true);
+  bld.add_u64_counter(TEST_PERFCOUNTERS_SHARDED_COUNTER, "counter");
+  bld.add_time_avg(TEST_PERFCOUNTERS_SHARDED_AVG, "avg");
+  bld.add_u64(TEST_PERFCOUNTERS_SHARDED_GAUGE, "gauge");
+  std::unique_ptr<PerfCounters> pf(bld.create_perf_counters());
+
+  constexpr int nthreads = 8;
+  constexpr int ninc = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nthreads; ++i) {
+    threads.emplace_back([&pf] {
+      for (int j = 0; j < ninc; ++j) {
+        pf->inc(TEST_PERFCOUNTERS_SHARDED_COUNTER);
+        pf->tinc(TEST_PERFCOUNTERS_SHARDED_AVG, ceph::timespan(2));
+        pf->inc(TEST_PERFCOUNTERS_SHARDED_GAUGE);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // reads add up every thread's slot
+  ASSERT_EQ(uint64_t(nthreads * ninc), pf->get(TEST_PERFCOUNTERS_SHARDED_COUNTER));
+  ASSERT_EQ(uint64_t(nthreads * ninc), pf->get(TEST_PERFCOUNTERS_SHARDED_GAUGE));
+  auto [sum, count] = pf->get_tavg_ns(TEST_PERFCOUNTERS_SHARDED_AVG);
+  ASSERT_EQ(uint64_t(nthreads * ninc), count);
+  ASSERT_EQ(uint64_t(2 * nthreads * ninc), sum);
+
+  // set() replaces whatever the shards accumulated
+  pf->set(TEST_PERFCOUNTERS_SHARDED_COUNTER, 5);
+  ASSERT_EQ(5u, pf->get(TEST_PERFCOUNTERS_SHARDED_COUNTER));
+  pf->inc(TEST_PERFCOUNTERS_SHARDED_COUNTER);
+  ASSERT_EQ(6u, pf->get(TEST_PERFCOUNTERS_SHARDED_COUNTER));
+
+  pf->reset();
+  ASSERT_EQ(0u, pf->get(TEST_PERFCOUNTERS_SHARDED_COUNTER));
+  ASSERT_EQ(std::make_pair(uint64_t(0), uint64_t(0)),
+            pf->get_tavg_ns(TEST_PERFCOUNTERS_SHARDED_AVG));
+}
+
 static PerfCounters* setup_test_perfcounter4(std::string name, CephContext *cct)
 {
   PerfCountersBuilder bld(cct, name,
@@ -0,0 +1,118 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+/*
+ * Microbenchmark for rgw::IAM::Policy::eval() against large policies.
+ *
+ *   bench_rgw_iam_policy [--statements N] [--iterations N]
+ *
+ * Builds an identity-style policy of <statements> statements, each granting
+ * one of a handful of actions on its own bucket, and reports the time per
+ * eval() for an action named by every statement, an action named by a few
+ * and an action named by none.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <boost/intrusive_ptr.hpp>
+#include <fmt/format.h>
+
+#include "common/ceph_context.h"
+#include "rgw_iam_policy.h"
+
+using namespace rgw::IAM;
+
+namespace {
+
+std::string make_policy(unsigned statements)
+{
+  static const char* actions[] = {
+    "s3:GetObject", "s3:PutObject", "s3:DeleteObject", "s3:ListBucket",
+    "s3:GetObjectTagging", "s3:PutObjectTagging", "s3:GetObjectAcl",
+    "s3:AbortMultipartUpload"
+  };
+  std::string text = R"({"Version": "2012-10-17", "Statement": [)";
+  for (unsigned i = 0; i < statements; ++i) {
+    if (i > 0) {
+      text += ",";
+    }
+    // every statement also grants s3:GetObject so that action has to
+    // visit all of them
+    text += fmt::format(R"({{"Effect": "Allow",
+      "Action": ["s3:GetObject", "{}"],
+      "Resource": ["arn:aws:s3:::bucket{}", "arn:aws:s3:::bucket{}/*"]}})",
+      actions[1 + i % (std::size(actions) - 1)], i, i);
+  }
+  text += "]}";
+  return text;
+}
+
+void run(const Policy& p, const char* name, uint64_t action,
+         const rgw::ARN& arn, uint64_t iterations)
+{
+  using namespace std::chrono;
+  const Environment env;
+  unsigned allowed = 0;
+  const auto start = steady_clock::now();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    allowed += (p.eval(env, boost::none, action, arn) == Effect::Allow);
+  }
+  const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+  std::cout << fmt::format("{:<28} {:>10.1f} ns/op ({} allowed)", name,
+                           double(elapsed.count()) / iterations, allowed)
+            << std::endl;
+}
+
+void usage()
+{
+  std::cerr << "usage: bench_rgw_iam_policy [--statements N] "
+      "[--iterations N]" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned statements = 500;
+  uint64_t iterations = 100000;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 >= argc) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    const uint64_t val = std::strtoull(argv[i + 1], nullptr, 10);
+    if (std::strcmp(argv[i], "--statements") == 0) {
+      statements = std::max<uint64_t>(1, val);
+    } else if (std::strcmp(argv[i], "--iterations") == 0) {
+      iterations = std::max<uint64_t>(1, val);
+    } else {
+      usage();
+      return EXIT_FAILURE;
+    }
+    ++i;
+  }
+
+  boost::intrusive_ptr<CephContext> cct{
+    new CephContext(CEPH_ENTITY_TYPE_CLIENT), false};
+  const std::string tenant;
+
+  const auto parse_start = std::chrono::steady_clock::now();
+  const Policy p(cct.get(), &tenant, make_policy(statements), false);
+  const auto parse_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - parse_start);
+  std::cout << statements << " statements parsed in " << parse_us.count()
+      << " us" << std::endl;
+
+  const auto last = fmt::format("bucket{}/obj", statements - 1);
+  const rgw::ARN arn(rgw::Partition::aws, rgw::Service::s3, "", tenant, last);
+  run(p, "s3:GetObject (all)", s3GetObject, arn, iterations);
+  run(p, "s3:PutObject (some)", s3PutObject, arn, iterations);
+  run(p, "s3:GetBucketAcl (none)", s3GetBucketAcl, arn, iterations);
+  return EXIT_SUCCESS;
+}
@@ -3416,6 +3416,83 @@ def test_persistent_topic_stats_amqp():
     persistent_topic_stats(conn, 'amqp')
 
 
+@pytest.mark.http_test
+def test_persistent_shared_reservation_http():
+    """ test queue reservations shared by notifications on the same topic """
+    conn = connection()
+    zonegroup = get_config_zonegroup()
+
+    # create bucket
+    bucket_name = gen_bucket_name()
+    bucket = conn.create_bucket(bucket_name)
+    topic_name = bucket_name + TOPIC_SUFFIX
+
+    # create topic with an endpoint that is not listening, so that events
+    # stay in the queue
+    host = get_ip()
+    wrong_port = 1234
+    endpoint_address = 'http://'+host+':'+str(wrong_port)
+    endpoint_args = 'push-endpoint='+endpoint_address+'&persistent=true'+ \
+                    '&retry_sleep_duration=1'
+    topic_conf = PSTopicS3(conn, topic_name, zonegroup, endpoint_args=endpoint_args)
+    topic_arn = topic_conf.set_config()
+    # two notifications on the same topic, both matching every put, so each
+    # put reserves once for two events on the same queue shard
+    topic_conf_list = [{'Id': bucket_name + NOTIFICATION_SUFFIX + '_1',
+                        'TopicArn': topic_arn,
+                        'Events': ['s3:ObjectCreated:*']
+                        },
+                       {'Id': bucket_name + NOTIFICATION_SUFFIX + '_2',
+                        'TopicArn': topic_arn,
+                        'Events': ['s3:ObjectCreated:Put']
+                        }]
+    s3_notification_conf = PSNotificationS3(conn, bucket_name, topic_conf_list)
+    response, status = s3_notification_conf.set_config()
+    assert status/100 == 2
+
+    def check_stats(expected_entries):
+        stats = get_stats_persistent_topic(topic_name, expected_entries)['Topic Stats']
+        assert stats['Entries'] == expected_entries
+        # every reservation was either committed or aborted
+        assert stats['Reservations'] == 0
+
+    client = boto3.client('s3',
+                          endpoint_url='http://'+conn.host+':'+str(conn.port),
+                          aws_access_key_id=conn.aws_access_key_id,
+                          aws_secret_access_key=conn.aws_secret_access_key,
+                          config=Config(s3={'addressing_style': 'path'}))
+
+    # shared reservation: one event per notification
+    number_of_objects = 10
+    for i in range(number_of_objects):
+        client.put_object(Bucket=bucket_name, Key='key-'+str(i), Body='bar')
+    check_stats(2 * number_of_objects)
+
+    # events larger than the default reservation: the shared reservation
+    # is replaced by a larger one at commit time
+    big_metadata = {'big-'+str(i): 'x'*2000 for i in range(4)}
+    for i in range(2):
+        client.put_object(Bucket=bucket_name, Key='big-key-'+str(i), Body='bar',
+                          Metadata=big_metadata)
+    check_stats(2 * (number_of_objects + 2))
+
+    # a put that fails after the reservation was made aborts it
+    try:
+        client.put_object(Bucket=bucket_name, Key='bad-digest', Body='bar',
+                          ContentMD5='1B2M2Y8AsgTpgAmY7PhCfg==')
+        assert False, 'put with a wrong Content-MD5 should fail'
+    except ClientError as e:
+        assert e.response['Error']['Code'] == 'BadDigest'
+    check_stats(2 * (number_of_objects + 2))
+
+    # cleanup
+    s3_notification_conf.del_config()
+    topic_conf.del_config()
+    for key in bucket.list():
+        key.delete()
+    conn.delete_bucket(bucket_name)
+
+
 @pytest.mark.kafka_test
 def test_persistent_topic_dump():
     """ test persistent topic dump """
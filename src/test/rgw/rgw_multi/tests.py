@@ -2769,6 +2769,46 @@ def test_bucket_full_sync_after_data_sync_init():
     zonegroup_bucket_checkpoint(zonegroup_conns, bucket.name)
     zonegroup_data_checkpoint(zonegroup_conns)
 
+@attr('fails_with_rgw')
+@attr('data_sync_init')
+def test_bucket_full_sync_listing_errors():
+    """
+    bucket full sync over several listing pages completes even when remote
+    listings fail, including the prefetch of the next page
+    """
+    zonegroup = realm.master_zonegroup()
+    zonegroup_conns = ZonegroupConns(zonegroup)
+    primary = zonegroup_conns.rw_zones[0]
+    secondary = zonegroup_conns.rw_zones[1]
+
+    bucket = primary.create_bucket(gen_bucket_name())
+    log.debug('created bucket=%s', bucket.name)
+    zonegroup_meta_checkpoint(zonegroup)
+
+    # more than 1000 objects, so that full sync lists several pages
+    keys = [f'obj-{i:04d}' for i in range(2500)]
+    inject_opt = 'rgw_sync_bucket_list_inject_err_probability'
+    try:
+        # stop secondary zone before it starts a bucket full sync
+        secondary.zone.stop()
+
+        for key in keys:
+            primary.s3_client.put_object(Bucket=bucket.name, Key=key, Body='foo')
+
+        cmd = ['data', 'sync', 'init'] + secondary.zone.zone_args()
+        cmd += ['--source-zone', primary.name]
+        secondary.zone.cluster.admin(cmd)
+        secondary.zone.cluster.ceph_admin(['config', 'set', 'client.rgw', inject_opt, '0.3'])
+    finally:
+        # Do this as a finally so we bring the zone back up even on error.
+        secondary.zone.start()
+
+    try:
+        # expect all objects to replicate via 'bucket full sync'
+        zonegroup_bucket_checkpoint(zonegroup_conns, bucket.name)
+    finally:
+        secondary.zone.cluster.ceph_admin(['config', 'rm', 'client.rgw', inject_opt])
+
 @attr('fails_with_rgw')
 @attr('data_sync_init')
 @attr('bucket_reshard')
@@ -5626,6 +5666,66 @@ def test_bucket_delete_with_sync_policy_object_prefix():
 
     return
 
+@attr('sync_policy')
+@attr('fails_with_rgw')
+@attr('data_sync_init')
+def test_bucket_full_sync_with_sync_policy_object_prefix():
+    """
+    bucket full sync of a pipe with an object prefix: the first listing page
+    only holds keys outside the prefix, so the prefix rules move the marker
+    past the prefetched page, which must be dropped and listed again
+    """
+    zonegroup = realm.master_zonegroup()
+    zonegroup_conns = ZonegroupConns(zonegroup)
+
+    zonegroup_meta_checkpoint(zonegroup)
+
+    (zoneA, zoneB) = zonegroup.zones[0:2]
+    (zcA, zcB) = zonegroup_conns.zones[0:2]
+
+    c1 = zoneA.cluster
+
+    zones = zoneA.name + ',' + zoneB.name
+    create_sync_policy_group(c1, "sync-group")
+    create_sync_group_flow_symmetrical(c1, "sync-group", "sync-flow", zones)
+    create_sync_group_pipe(c1, "sync-group", "sync-pipe", zones, zones)
+    set_sync_policy_group_status(c1, "sync-group", "allowed")
+
+    zonegroup.period.update(zoneA, commit=True)
+
+    bucket = create_zone_bucket(zcA)
+    create_sync_policy_group(c1, "sync-bucket", "allowed", bucket.name)
+    create_sync_group_flow_directional(c1, "sync-bucket", "sync-flow-bucket",
+                                       zoneA.name, zoneB.name, bucket.name)
+    create_sync_group_pipe(c1, "sync-bucket", "sync-pipe", zoneA.name, zoneB.name,
+                           bucket.name, ['--prefix=b/'])
+    set_sync_policy_group_status(c1, "sync-bucket", "enabled", bucket.name)
+
+    zonegroup_meta_checkpoint(zonegroup)
+
+    excluded = [f'a/{i:04d}' for i in range(1500)]
+    included = [f'b/{i:04d}' for i in range(1500)]
+    try:
+        # stop zoneB before it starts a bucket full sync
+        zoneB.stop()
+
+        for key in excluded + included:
+            zcA.s3_client.put_object(Bucket=bucket.name, Key=key, Body='foo')
+
+        cmd = ['data', 'sync', 'init'] + zoneB.zone_args()
+        cmd += ['--source-zone', zoneA.name]
+        zoneB.cluster.admin(cmd)
+    finally:
+        zoneB.start()
+
+    zone_bucket_checkpoint(zoneB, zoneA, bucket.name)
+
+    check_objects_exist(zcB, bucket.name, included, 'foo')
+    check_objects_not_exist(zcB, bucket.name, excluded[::100])
+
+    remove_sync_policy_group(c1, "sync-bucket", bucket.name)
+    remove_sync_policy_group(c1, "sync-group")
+
 @run_per_zonegroup
 def test_copy_obj_between_zonegroups(zonegroup):
     if len(realm.current_period.zonegroups) < 2:
@@ -1,5 +1,6 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/redis/connection.hpp>
 
 #include "common/async/context_pool.h"
@@ -16,6 +17,7 @@
 #include "driver/dbstore/common/dbstore.h"
 #include "rgw_sal_d4n.h"
 #include "rgw_sal_filter.h"
+#include "rgw_perf_counters.h"
 
 #define dout_subsys ceph_subsys_rgw
 
@@ -419,6 +421,75 @@ TEST_F(D4NFilterFixture, GetObjectRead)
   io.run();
 }
 
+TEST_F(D4NFilterFixture, PrefetchSequentialRead)
+{
+  const std::string testName = "PrefetchSequentialRead";
+  const auto max_chunk_size = env->cct->_conf->rgw_max_chunk_size;
+  const auto prefetch_blocks = env->cct->_conf->rgw_d4n_prefetch_blocks;
+  if (!perfcounter) {
+    rgw_perf_start(env->cct.get());
+  }
+ 
+  net::spawn(io, [this, &testName] (net::yield_context yield) {
+    init_driver(yield);
+    create_bucket(testName, yield);
+    put_object(testName, yield);
+
+    // Only a read that continues the previous one of the same object is sequential
+    EXPECT_FALSE(d4nFilter->is_sequential_read(testName, 0, 3));
+    EXPECT_TRUE(d4nFilter->is_sequential_read(testName, 4, 7));
+    EXPECT_FALSE(d4nFilter->is_sequential_read(testName, 0, 3));
+    EXPECT_FALSE(d4nFilter->is_sequential_read(testName + "_other", 4, 7));
+
+    // "test data" is read in three blocks of 4, 4 and 1 bytes
+    env->cct->_conf->rgw_max_chunk_size = 4;
+    env->cct->_conf->rgw_d4n_prefetch_blocks = 1;
+
+    bufferlist bl;
+    Read_CB cb(&bl);
+    auto read = [&] (int64_t ofs, int64_t end) {
+      std::unique_ptr<rgw::sal::Object::ReadOp> read_op(obj->get_read_op());
+      EXPECT_EQ(read_op->prepare(optional_yield{yield}, env->dpp), 0);
+      EXPECT_EQ(read_op->iterate(env->dpp, ofs, end, &cb, optional_yield{yield}), 0);
+    };
+    read(0, 3);
+    read(4, 7); // sequential miss, prefetches the last block
+
+    auto d4nObj = dynamic_cast<rgw::sal::D4NFilterObject*>(obj.get());
+    const std::string prefetched = rgw::sal::get_key_in_cache(d4nObj->get_prefix(), "8", "1");
+    auto policy = d4nFilter->get_policy_driver()->get_cache_policy();
+    net::steady_timer timer(io);
+    for (int i = 0; i < 100 && !policy->exist_key(prefetched); ++i) {
+      timer.expires_after(std::chrono::milliseconds(10));
+      timer.async_wait(yield);
+    }
+    EXPECT_TRUE(policy->exist_key(prefetched));
+
+    // Served from the cache
+    const auto misses = perfcounter->get(l_rgw_d4n_cache_misses);
+    read(8, 8);
+    EXPECT_EQ(perfcounter->get(l_rgw_d4n_cache_misses), misses);
+    EXPECT_EQ(bl.to_str(), "test data");
+
+    // shutdown() waits for prefetches, let ours finish on this thread first
+    for (int i = 0; i < 100 && d4nFilter->get_prefetches() > 0; ++i) {
+      timer.expires_after(std::chrono::milliseconds(10));
+      timer.async_wait(yield);
+    }
+    EXPECT_EQ(d4nFilter->get_prefetches(), 0);
+
+    conn->cancel();
+    testBucket->remove(env->dpp, true, optional_yield{yield});
+    driver->shutdown();
+    DriverDestructor driver_destructor(static_cast<rgw::sal::D4NFilterDriver*>(driver)); 
+  }, rethrow);
+
+  io.run();
+
+  env->cct->_conf->rgw_max_chunk_size = max_chunk_size;
+  env->cct->_conf->rgw_d4n_prefetch_blocks = prefetch_blocks;
+}
+
 TEST_F(D4NFilterFixture, CopyNoneObjectRead)
 {
   const std::string testName = "CopyNoneObjectRead";
@@ -18,6 +18,8 @@
 #include <string_view>
 
 #include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
 #include <boost/system/errc.hpp>
@@ -29,6 +31,8 @@
 
 #include "neorados/cls/sem_set.h"
 
+#include "rgw_perf_counters.h"
+
 #include "test/neorados/common_tests.h"
 
 #include "gtest/gtest.h"
@@ -479,3 +483,45 @@ CORO_TEST_F(DataLogBulky, BulkySemaphoresRecovery, DataLogBulky) {
   }
   co_return;
 }
+
+// Writers that log to the same shard concurrently are pushed as one group,
+// and every one of them returns once it is written.
+CORO_TEST_F(DataLogBulky, GroupCommit, DataLogBulky) {
+  using namespace std::literals;
+  auto cct = rados().cct();
+  if (!perfcounter) {
+    rgw_perf_start(cct);
+  }
+  // long enough that every writer joins the first one's group
+  cct->_conf.set_val_or_die("rgw_data_log_group_commit_window_ms", "1000");
+  const auto writes = perfcounter->get(l_rgw_datalog_group_writes);
+  const auto entries = perfcounter->get(l_rgw_datalog_group_entries);
+
+  auto ex = co_await asio::this_coro::executor;
+  auto returned = std::make_shared<std::size_t>(0);
+  for (const auto& bg : bulky) {
+    asio::co_spawn(ex, add_entry(dpp(), bg),
+		   [returned](std::exception_ptr e) {
+		     if (!e) {
+		       ++*returned;
+		     }
+		   });
+  }
+  asio::steady_timer timer(ex);
+  for (auto i = 0; i < 300 && *returned < bulky.size(); ++i) {
+    timer.expires_after(100ms);
+    co_await timer.async_wait(asio::use_awaitable);
+  }
+  cct->_conf.rm_val("rgw_data_log_group_commit_window_ms");
+
+  EXPECT_EQ(bulky.size(), *returned);
+  EXPECT_EQ(1u, perfcounter->get(l_rgw_datalog_group_writes) - writes);
+  EXPECT_EQ(bulky.size(),
+	    perfcounter->get(l_rgw_datalog_group_entries) - entries);
+
+  auto log_entries = co_await read_all_log(dpp());
+  for (const auto& bg : bulky) {
+    EXPECT_TRUE(log_entries.contains(bg));
+  }
+  co_return;
+}
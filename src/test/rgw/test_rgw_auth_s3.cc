@@ -0,0 +1,68 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab ft=cpp
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "rgw_auth_s3.h"
+
+using rgw::auth::s3::SigningKeyCache;
+
+namespace {
+
+const std::string_view scope = "20260101/us-east-1/s3/aws4_request";
+
+sha256_digest_t make_key(unsigned char c)
+{
+  sha256_digest_t key;
+  std::fill(std::begin(key.v), std::end(key.v), c);
+  return key;
+}
+
+} // anonymous namespace
+
+TEST(SigningKeyCache, hit)
+{
+  SigningKeyCache cache{100};
+  ASSERT_TRUE(cache.enabled());
+
+  sha256_digest_t found;
+  EXPECT_FALSE(cache.find("AKID", scope, "secret", found));
+
+  const auto key = make_key(1);
+  cache.add("AKID", scope, "secret", key);
+  ASSERT_TRUE(cache.find("AKID", scope, "secret", found));
+  EXPECT_EQ(key, found);
+
+  // entries are per access key and per scope
+  EXPECT_FALSE(cache.find("OTHER", scope, "secret", found));
+  EXPECT_FALSE(cache.find("AKID", "20260102/us-east-1/s3/aws4_request",
+                          "secret", found));
+}
+
+TEST(SigningKeyCache, secret_rotation)
+{
+  SigningKeyCache cache{100};
+  cache.add("AKID", scope, "old-secret", make_key(1));
+
+  // a key derived from the old secret is never returned for the new one
+  sha256_digest_t found;
+  EXPECT_FALSE(cache.find("AKID", scope, "new-secret", found));
+
+  const auto key = make_key(2);
+  cache.add("AKID", scope, "new-secret", key);
+  ASSERT_TRUE(cache.find("AKID", scope, "new-secret", found));
+  EXPECT_EQ(key, found);
+  EXPECT_FALSE(cache.find("AKID", scope, "old-secret", found));
+}
+
+TEST(SigningKeyCache, disabled)
+{
+  SigningKeyCache cache{0};
+  EXPECT_FALSE(cache.enabled());
+
+  cache.add("AKID", scope, "secret", make_key(1));
+  sha256_digest_t found;
+  EXPECT_FALSE(cache.find("AKID", scope, "secret", found));
+}
@@ -727,6 +727,31 @@ TEST(RGWCksum, CRC32C_COMBINE3)
   ASSERT_EQ(cksum3.to_armor(), cksum4->to_armor());
 } /* crc32c */
 
+TEST(RGWCksum, HashBuffers)
+{
+  /* hashing a fragmented bufferlist buffer by buffer must match
+   * hashing the same bytes flat */
+  for (const auto t : {cksum::Type::crc32c, cksum::Type::sha256}) {
+    DigestVariant dv1 = rgw::cksum::digest_factory(t);
+    Digest* flat = get_digest(dv1);
+    flat->Update((const unsigned char *)dolor.c_str(), dolor.length());
+
+    ceph::buffer::list bl;
+    for (size_t off = 0; off < dolor.length(); off += 37) {
+      bl.append(buffer::copy(dolor.data() + off,
+			     std::min<size_t>(37, dolor.length() - off)));
+    }
+    ASSERT_GT(bl.get_num_buffers(), 1u);
+
+    DigestVariant dv2 = rgw::cksum::digest_factory(t);
+    Digest* frag = get_digest(dv2);
+    rgw::putobj::hash_buffers(*frag, bl);
+
+    ASSERT_EQ(rgw::cksum::finalize_digest(flat, t).to_armor(),
+	      rgw::cksum::finalize_digest(frag, t).to_armor());
+  }
+}
+
 TEST(RGWCksum, CtorUnarmor)
 {
   auto t = cksum::Type::sha256;
@@ -0,0 +1,72 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+#include "driver/rados/rgw_dedup_utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace rgw::dedup;
+
+static md5_stats_t make_stats()
+{
+  md5_stats_t m;
+  m.ingress_slabs = 1;
+  m.deduped_objects = 2;
+  m.failed_map_overflow = 3;
+  m.duration = utime_t(4, 5);
+  m.calc_hash_objs = 6;
+  m.calc_hash_bytes = 7;
+  m.calc_hash_time_usec = 8;
+  return m;
+}
+
+TEST(DedupStats, MD5StatsRoundTrip)
+{
+  const md5_stats_t m = make_stats();
+  bufferlist bl;
+  encode(m, bl);
+
+  md5_stats_t d;
+  auto p = bl.cbegin();
+  decode(d, p);
+  EXPECT_EQ(d.ingress_slabs, 1u);
+  EXPECT_EQ(d.deduped_objects, 2u);
+  EXPECT_EQ(d.failed_map_overflow, 3u);
+  EXPECT_EQ(d.duration, utime_t(4, 5));
+  EXPECT_EQ(d.calc_hash_objs, 6u);
+  EXPECT_EQ(d.calc_hash_bytes, 7u);
+  EXPECT_EQ(d.calc_hash_time_usec, 8u);
+}
+
+TEST(DedupStats, MD5StatsDecodeV1)
+{
+  // v1 is the v2 encoding without the three trailing hash counters
+  md5_stats_t m = make_stats();
+  bufferlist v2;
+  encode(m, v2);
+
+  constexpr unsigned v2_only_len = 3 * sizeof(uint64_t);
+  bufferlist v1;
+  v2.begin(0).copy(v2.length() - v2_only_len, v1);
+  v1.rebuild();
+  char* raw = v1.c_str();
+  // header: struct_v, compat_v, le32 payload length
+  ASSERT_EQ(raw[0], 2);
+  raw[0] = 1;
+  ceph_le32 len;
+  memcpy(&len, raw + 2, sizeof(len));
+  len = (uint32_t)len - v2_only_len;
+  memcpy(raw + 2, &len, sizeof(len));
+
+  md5_stats_t d;
+  auto p = v1.cbegin();
+  decode(d, p);
+  EXPECT_TRUE(p.end());
+  EXPECT_EQ(d.ingress_slabs, 1u);
+  EXPECT_EQ(d.deduped_objects, 2u);
+  EXPECT_EQ(d.failed_map_overflow, 3u);
+  EXPECT_EQ(d.duration, utime_t(4, 5));
+  EXPECT_EQ(d.calc_hash_objs, 0u);
+  EXPECT_EQ(d.calc_hash_bytes, 0u);
+  EXPECT_EQ(d.calc_hash_time_usec, 0u);
+}
@@ -0,0 +1,106 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+#include "rgw_gc.h"
+
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(GCWalkShards, Serial)
+{
+  std::vector<int> order;
+  std::vector<int> finished;
+  int r = gc_walk_shards(nullptr, 4, 8, 5,
+      [&] (int worker, int shard) {
+        EXPECT_EQ(0, worker);
+        order.push_back(shard);
+        return 0;
+      },
+      [&] (int worker) { finished.push_back(worker); },
+      [] { return false; });
+  EXPECT_EQ(0, r);
+  // without a pool, the calling thread walks every shard from start
+  EXPECT_EQ((std::vector<int>{5, 6, 7, 0, 1, 2, 3, 4}), order);
+  EXPECT_EQ(std::vector<int>{0}, finished);
+}
+
+TEST(GCWalkShards, Concurrent)
+{
+  constexpr int num_workers = 4;
+  constexpr int num_shards = 64;
+  ceph::async::io_context_pool pool(num_workers - 1);
+
+  std::mutex lock;
+  std::multiset<int> shards;
+  std::set<int> workers;
+  std::set<std::thread::id> threads;
+  std::vector<int> finished(num_workers, 0);
+  int r = gc_walk_shards(&pool, num_workers, num_shards, 3,
+      [&] (int worker, int shard) {
+        // hold each shard long enough for the other workers to claim some
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard l{lock};
+        shards.insert(shard);
+        workers.insert(worker);
+        threads.insert(std::this_thread::get_id());
+        return 0;
+      },
+      [&] (int worker) {
+        std::lock_guard l{lock};
+        ++finished[worker];
+      },
+      [] { return false; });
+  EXPECT_EQ(0, r);
+
+  // every shard exactly once, spread over more than one thread
+  ASSERT_EQ(num_shards, (int)shards.size());
+  for (int i = 0; i < num_shards; ++i) {
+    EXPECT_EQ(1u, shards.count(i)) << "shard " << i;
+  }
+  EXPECT_GT(workers.size(), 1u);
+  EXPECT_EQ(workers.size(), threads.size());
+  // each worker finishes once, and the walk only returns after all did
+  EXPECT_EQ(std::vector<int>(num_workers, 1), finished);
+}
+
+TEST(GCWalkShards, StopsOnError)
+{
+  ceph::async::io_context_pool pool(2);
+
+  std::atomic<int> calls{0};
+  std::atomic<int> finished{0};
+  int r = gc_walk_shards(&pool, 3, 1000, 0,
+      [&] (int, int shard) {
+        ++calls;
+        return shard == 10 ? -EIO : 0;
+      },
+      [&] (int) { ++finished; },
+      [] { return false; });
+  EXPECT_EQ(-EIO, r);
+  // workers may each have claimed one more shard before seeing the error
+  EXPECT_LT(calls, 1000);
+  EXPECT_EQ(3, finished);
+}
+
+TEST(GCWalkShards, StopsWhenGoingDown)
+{
+  ceph::async::io_context_pool pool(1);
+
+  std::atomic<int> calls{0};
+  std::atomic<bool> down{false};
+  int r = gc_walk_shards(&pool, 2, 100, 0,
+      [&] (int, int) {
+        if (++calls == 5) {
+          down = true;
+        }
+        return 0;
+      },
+      [] (int) {},
+      [&] { return down.load(); });
+  EXPECT_EQ(0, r);
+  EXPECT_LT(calls, 100);
+}
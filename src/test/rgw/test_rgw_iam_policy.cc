@@ -86,6 +86,7 @@ using rgw::IAM::s3ListMultipartUploadParts;
 using rgw::IAM::None;
 using rgw::IAM::s3PutBucketAcl;
 using rgw::IAM::s3PutBucketPolicy;
+using rgw::IAM::PolicyPrincipal;
 using rgw::IAM::s3GetBucketObjectLockConfiguration;
 using rgw::IAM::s3GetObjectRetention;
 using rgw::IAM::s3GetObjectLegalHold;
@@ -229,6 +230,7 @@ protected:
   static string example5;
   static string example6;
   static string example7;
+  static string example8;
 public:
   PolicyTest() {
     cct.reset(new CephContext(CEPH_ENTITY_TYPE_CLIENT), false);
@@ -800,6 +802,41 @@ TEST_F(PolicyTest, Eval7) {
 	    Effect::Pass);
 }
 
+TEST_F(PolicyTest, ActionIndex) {
+  auto p = Policy(cct.get(), &arbitrary_tenant, example8, true);
+  ASSERT_EQ(p.statements.size(), 3U);
+
+  // each action only lists the statements naming it
+  auto indexed = [&p] (uint64_t a) {
+    return std::vector<uint32_t>(
+        p.action_statements.begin() + p.action_offsets[a],
+        p.action_statements.begin() + p.action_offsets[a + 1]);
+  };
+  EXPECT_EQ(indexed(s3GetObject), std::vector<uint32_t>{0});
+  EXPECT_EQ(indexed(s3PutBucketPolicy), (std::vector<uint32_t>{0, 1}));
+  EXPECT_EQ(indexed(s3ListBucket), std::vector<uint32_t>{2});
+  EXPECT_TRUE(indexed(s3GetBucketAcl).empty());
+
+  Environment e;
+  auto acct = FakeIdentity(Principal::user(std::move(""), "A"));
+  ARN bucket(Partition::aws, Service::s3, "", arbitrary_tenant, "mybucket");
+  ARN object(Partition::aws, Service::s3, "", arbitrary_tenant, "mybucket/obj");
+
+  PolicyPrincipal princ_type = PolicyPrincipal::Session;
+  EXPECT_EQ(p.eval(e, acct, s3GetObject, object, princ_type), Effect::Allow);
+  EXPECT_EQ(princ_type, PolicyPrincipal::Other);
+  EXPECT_EQ(p.eval(e, acct, s3PutBucketPolicy, bucket), Effect::Deny);
+  EXPECT_EQ(p.eval(e, acct, s3ListBucket, bucket), Effect::Pass);
+  princ_type = PolicyPrincipal::Session;
+  EXPECT_EQ(p.eval(e, acct, s3GetBucketAcl, bucket, princ_type), Effect::Pass);
+  EXPECT_EQ(princ_type, PolicyPrincipal::Other);
+
+  // statements edited after parsing need a new index
+  p.statements[2].action[s3GetBucketAcl] = 1;
+  p.compile();
+  EXPECT_EQ(indexed(s3GetBucketAcl), std::vector<uint32_t>{2});
+}
+
 
 class ManagedPolicyTest : public ::testing::Test {
 protected:
@@ -1054,6 +1091,32 @@ string PolicyTest::example7 = R"(
   }
 }
 )";
+
+string PolicyTest::example8 = R"(
+{
+  "Version": "2012-10-17",
+  "Statement": [
+    {
+      "Effect": "Allow",
+      "Principal": {"AWS": ["arn:aws:iam:::user/A"]},
+      "Action": ["s3:GetObject", "s3:PutBucketPolicy"],
+      "Resource": ["arn:aws:s3:::mybucket", "arn:aws:s3:::mybucket/*"]
+    },
+    {
+      "Effect": "Deny",
+      "Principal": "*",
+      "Action": "s3:PutBucketPolicy",
+      "Resource": "arn:aws:s3:::mybucket"
+    },
+    {
+      "Effect": "Allow",
+      "Principal": {"AWS": ["arn:aws:iam:::user/B"]},
+      "Action": "s3:ListBucket",
+      "Resource": "arn:aws:s3:::mybucket"
+    }
+  ]
+}
+)";
 class IPPolicyTest : public ::testing::Test {
 protected:
   intrusive_ptr<CephContext> cct;
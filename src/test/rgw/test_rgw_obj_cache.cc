@@ -0,0 +1,138 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab ft=cpp
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "common/dout.h"
+#include "global/global_context.h"
+#include "rgw_cache.h"
+
+namespace {
+
+struct CountingChainedCache : RGWChainedCache {
+  std::map<std::string, int> chained;
+  int invalidated = 0;
+
+  void chain_cb(const std::string& key, void *data) override {
+    ++chained[key];
+  }
+  void invalidate(const std::string& key) override {
+    ++invalidated;
+  }
+  void invalidate_all() override {
+    chained.clear();
+  }
+};
+
+ObjectCacheInfo make_info(const std::string& data) {
+  ObjectCacheInfo info;
+  info.status = 0;
+  info.flags = CACHE_FLAG_DATA;
+  info.data.append(data);
+  return info;
+}
+
+class ObjectCacheTest : public ::testing::Test {
+protected:
+  NoDoutPrefix dpp{g_ceph_context, ceph_subsys_rgw};
+  ObjectCache cache;
+
+  void SetUp() override {
+    // rgw_cache_shards is left at its default of 16
+    g_ceph_context->_conf.set_val_or_die("rgw_cache_lru_size", "160");
+    cache.set_ctx(g_ceph_context);
+    cache.set_enabled(true);
+  }
+};
+
+} // anonymous namespace
+
+TEST_F(ObjectCacheTest, put_get_invalidate)
+{
+  ASSERT_EQ(16u, cache.get_num_shards());
+  for (int i = 0; i < 40; ++i) {
+    auto info = make_info("data" + std::to_string(i));
+    cache.put(&dpp, "obj" + std::to_string(i), info, nullptr);
+  }
+  for (int i = 0; i < 40; ++i) {
+    ObjectCacheInfo info;
+    ASSERT_EQ(0, cache.get(&dpp, "obj" + std::to_string(i), info,
+                           CACHE_FLAG_DATA, nullptr));
+    EXPECT_EQ("data" + std::to_string(i), info.data.to_str());
+  }
+  EXPECT_TRUE(cache.invalidate_remove(&dpp, "obj7"));
+  EXPECT_FALSE(cache.get(&dpp, "obj7"));
+  EXPECT_FALSE(cache.invalidate_remove(&dpp, "obj7"));
+
+  cache.invalidate_all();
+  EXPECT_FALSE(cache.get(&dpp, "obj0"));
+}
+
+TEST_F(ObjectCacheTest, eviction_is_bounded)
+{
+  for (int i = 0; i < 1000; ++i) {
+    auto info = make_info("x");
+    cache.put(&dpp, "obj" + std::to_string(i), info, nullptr);
+  }
+  size_t cached = 0;
+  cache.for_each([&cached] (const std::string&, const ObjectCacheEntry&) {
+    ++cached;
+  });
+  // each shard holds rgw_cache_lru_size / shards entries, and may
+  // overshoot by one while its LRU head is being touched
+  EXPECT_LE(cached, 160u + cache.get_num_shards());
+  EXPECT_GT(cached, 0u);
+}
+
+TEST_F(ObjectCacheTest, chained_entries_across_shards)
+{
+  CountingChainedCache chained;
+  cache.chain_cache(&chained);
+
+  rgw_cache_entry_info a, b;
+  auto info = make_info("a");
+  cache.put(&dpp, "bucket.a", info, &a);
+  info = make_info("b");
+  cache.put(&dpp, "bucket.b", info, &b);
+
+  const std::string key = "combined";
+  RGWChainedCache::Entry entry(&chained, key, nullptr);
+  ASSERT_TRUE(cache.chain_cache_entry(&dpp, {&a, &b}, &entry));
+  EXPECT_EQ(1, chained.chained[key]);
+
+  // invalidating either source invalidates the chained entry
+  EXPECT_TRUE(cache.invalidate_remove(&dpp, "bucket.b"));
+  EXPECT_EQ(1, chained.invalidated);
+
+  // a stale generation can't be chained
+  info = make_info("a2");
+  cache.put(&dpp, "bucket.a", info, nullptr);
+  EXPECT_FALSE(cache.chain_cache_entry(&dpp, {&a}, &entry));
+
+  cache.unchain_cache(&chained);
+}
+
+TEST_F(ObjectCacheTest, concurrent)
+{
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i < 2000; ++i) {
+        const auto name = "obj" + std::to_string((i * 7 + t) % 200);
+        if (i % 5 == 0) {
+          auto info = make_info(name);
+          cache.put(&dpp, name, info, nullptr);
+        } else if (i % 17 == 0) {
+          cache.invalidate_remove(&dpp, name);
+        } else if (auto info = cache.get(&dpp, name); info) {
+          EXPECT_EQ(name, info->data.to_str());
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
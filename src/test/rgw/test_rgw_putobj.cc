@@ -14,6 +14,12 @@
  */
 
 #include "rgw_putobj.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include "common/ceph_context.h"
 #include <gtest/gtest.h>
 
 inline bufferlist string_buf(const char* buf) {
@@ -195,3 +201,89 @@ TEST(PutObj_Stripe, SkipFirstChunk)
   ASSERT_EQ(4u, mock.ops.size());
   EXPECT_EQ(Op({"", 4}), mock.ops[3]); // flush
 }
+
+// reverses each buffer, taking longer for earlier offsets so that the
+// workers finish out of order
+static int slow_reverse(bufferlist& data, uint64_t offset)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(8 - offset % 8));
+  auto str = data.to_str();
+  std::reverse(str.begin(), str.end());
+  data.clear();
+  data.append(str);
+  return 0;
+}
+
+TEST(PutObj_Parallel, Ordered)
+{
+  boost::intrusive_ptr<CephContext> cct{
+    new CephContext(CEPH_ENTITY_TYPE_CLIENT), false};
+  for (size_t max_pending : {0, 1, 3, 16}) {
+    std::thread::id caller = std::this_thread::get_id();
+    MockProcessor mock;
+    rgw::putobj::ParallelProcessor processor(cct.get(), &mock,
+        slow_reverse, max_pending, null_yield);
+
+    for (uint64_t i = 0; i < 8; i++) {
+      ASSERT_EQ(0, processor.process(string_buf("ab"), i * 2));
+      // no more than max_pending - 1 buffers are left in flight
+      EXPECT_LE(i + 1 - mock.ops.size(), std::max<size_t>(max_pending, 1) - 1);
+    }
+    ASSERT_EQ(0, processor.process({}, 16)); // flush
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+
+    ASSERT_EQ(9u, mock.ops.size());
+    for (uint64_t i = 0; i < 8; i++) {
+      EXPECT_EQ(Op({"ba", i * 2}), mock.ops[i]);
+    }
+    EXPECT_EQ(Op({"", 16}), mock.ops[8]);
+  }
+}
+
+TEST(PutObj_Parallel, TransformError)
+{
+  boost::intrusive_ptr<CephContext> cct{
+    new CephContext(CEPH_ENTITY_TYPE_CLIENT), false};
+  MockProcessor mock;
+  rgw::putobj::ParallelProcessor processor(cct.get(), &mock,
+      [] (bufferlist& data, uint64_t offset) {
+        return offset == 2 ? -EIO : 0;
+      }, 4, null_yield);
+
+  int r = 0;
+  for (uint64_t i = 0; i < 4 && r == 0; i++) {
+    r = processor.process(string_buf("x"), i);
+  }
+  if (r == 0) {
+    r = processor.process({}, 4);
+  }
+  EXPECT_EQ(-EIO, r);
+  // nothing after the failed buffer was written
+  ASSERT_EQ(2u, mock.ops.size());
+  EXPECT_EQ(Op({"x", 1}), mock.ops[1]);
+}
+
+TEST(PutObj_Parallel, Yield)
+{
+  boost::intrusive_ptr<CephContext> cct{
+    new CephContext(CEPH_ENTITY_TYPE_CLIENT), false};
+  MockProcessor mock;
+  boost::asio::io_context context;
+  boost::asio::spawn(context,
+    [&] (boost::asio::yield_context yield) {
+      rgw::putobj::ParallelProcessor processor(cct.get(), &mock,
+          slow_reverse, 3, optional_yield{yield});
+      for (uint64_t i = 0; i < 8; i++) {
+        ASSERT_EQ(0, processor.process(string_buf("ab"), i * 2));
+      }
+      ASSERT_EQ(0, processor.process({}, 16));
+    }, [] (std::exception_ptr eptr) {
+      if (eptr) std::rethrow_exception(eptr);
+    });
+  context.run();
+
+  ASSERT_EQ(9u, mock.ops.size());
+  for (uint64_t i = 0; i < 8; i++) {
+    EXPECT_EQ(Op({"ba", i * 2}), mock.ops[i]);
+  }
+}
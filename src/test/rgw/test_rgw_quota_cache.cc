@@ -0,0 +1,170 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:nil -*-
+// vim: ts=8 sw=2 sts=2 expandtab
+
+#include "rgw_quota_cache.h"
+
+#include "global/global_context.h"
+
+#include "gtest/gtest.h"
+
+// RGWQuotaCache with the storage and the async refresh replaced by counters
+class TestStatsCache : public RGWQuotaCache<rgw_bucket> {
+protected:
+  bool map_find(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) override {
+    return stats_map.find(bucket, qs);
+  }
+
+  bool map_find_and_update(const rgw_owner& owner, const rgw_bucket& bucket, lru_map<rgw_bucket, RGWQuotaCacheStats>::UpdateContext *ctx) override {
+    return stats_map.find_and_update(bucket, NULL, ctx);
+  }
+
+  void map_add(const rgw_owner& owner, const rgw_bucket& bucket, RGWQuotaCacheStats& qs) override {
+    stats_map.add(bucket, qs);
+  }
+
+  int fetch_stats_from_storage(const rgw_owner& owner, const rgw_bucket& bucket, RGWStorageStats& stats, optional_yield y, const DoutPrefixProvider *dpp) override {
+    ++fetches;
+    stats = storage_stats;
+    return 0;
+  }
+
+public:
+  int fetches = 0;
+  int refreshes = 0;
+  int refresh_ret = 0;
+  RGWStorageStats storage_stats;
+
+  explicit TestStatsCache(CephContext *cct) : RGWQuotaCache<rgw_bucket>(cct, nullptr, 16) {}
+
+  int init_refresh(const rgw_owner& owner, const rgw_bucket& bucket,
+                   boost::intrusive_ptr<RefCountedWaitObject> waiter) override {
+    ++refreshes;
+    return refresh_ret;
+  }
+
+  // cache an entry that expires and is due for an async refresh relative to now
+  void add(const rgw_bucket& bucket, uint64_t size, double expires_in, double refresh_in) {
+    RGWQuotaCacheStats qs;
+    qs.stats.size = size;
+    qs.expiration = ceph_clock_now();
+    qs.expiration += expires_in;
+    qs.async_refresh_time = ceph_clock_now();
+    qs.async_refresh_time += refresh_in;
+    stats_map.add(bucket, qs);
+  }
+
+  RGWQuotaCacheStats find(const rgw_bucket& bucket) {
+    RGWQuotaCacheStats qs;
+    stats_map.find(bucket, qs);
+    return qs;
+  }
+};
+
+class QuotaCache : public ::testing::Test {
+protected:
+  const NoDoutPrefix dpp{g_ceph_context, ceph_subsys_rgw};
+  const rgw_owner owner = rgw_user("owner");
+  rgw_bucket bucket;
+  TestStatsCache cache{g_ceph_context};
+
+  void SetUp() override {
+    bucket.name = "bucket";
+    cache.storage_stats.size = 2;
+    g_ceph_context->_conf.set_val_or_die("rgw_bucket_quota_ttl", "600");
+  }
+  void TearDown() override {
+    g_ceph_context->_conf.set_val_or_die("rgw_bucket_quota_stale_ttl", "0");
+  }
+
+  uint64_t get_size() {
+    RGWStorageStats stats;
+    EXPECT_EQ(0, cache.get_stats(owner, bucket, stats, null_yield, &dpp));
+    return stats.size;
+  }
+};
+
+TEST_F(QuotaCache, ExpiredFetchedByDefault)
+{
+  cache.add(bucket, 1, -1, -5);
+
+  EXPECT_EQ(2u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(1, cache.fetches);
+}
+
+TEST_F(QuotaCache, StaleServedWhileRefreshInFlight)
+{
+  g_ceph_context->_conf.set_val_or_die("rgw_bucket_quota_stale_ttl", "60");
+  cache.add(bucket, 1, -1, -5);
+
+  // the request that starts the refresh is served from the cache too
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(0, cache.fetches);
+
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(0, cache.fetches);
+
+  RGWStorageStats refreshed;
+  refreshed.size = 3;
+  cache.async_refresh_response(owner, bucket, refreshed);
+  EXPECT_EQ(3u, get_size());
+  EXPECT_EQ(0, cache.fetches);
+}
+
+TEST_F(QuotaCache, StaleBounded)
+{
+  g_ceph_context->_conf.set_val_or_die("rgw_bucket_quota_stale_ttl", "60");
+  cache.add(bucket, 1, -120, -300);
+
+  EXPECT_EQ(2u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(1, cache.fetches);
+}
+
+TEST_F(QuotaCache, FailedRefreshBacksOff)
+{
+  cache.refresh_ret = -EIO;
+  cache.add(bucket, 1, 600, -1);
+
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+
+  // re-armed half a ttl ahead rather than retried by the next request
+  utime_t retry = ceph_clock_now();
+  retry += 200;
+  EXPECT_GT(cache.find(bucket).async_refresh_time, retry);
+
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(0, cache.fetches);
+}
+
+TEST_F(QuotaCache, FailedRefreshNotServedStale)
+{
+  g_ceph_context->_conf.set_val_or_die("rgw_bucket_quota_stale_ttl", "60");
+  cache.refresh_ret = -EIO;
+  cache.add(bucket, 1, -1, -1);
+
+  // no refresh in flight, so the expired stats are read from storage
+  EXPECT_EQ(2u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(1, cache.fetches);
+}
+
+TEST_F(QuotaCache, AsyncRefreshFailRearms)
+{
+  cache.add(bucket, 1, 600, -1);
+
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(0, cache.find(bucket).async_refresh_time.sec());
+
+  cache.async_refresh_fail(owner, bucket);
+  EXPECT_GT(cache.find(bucket).async_refresh_time, ceph_clock_now());
+
+  EXPECT_EQ(1u, get_size());
+  EXPECT_EQ(1, cache.refreshes);
+  EXPECT_EQ(0, cache.fetches);
+}
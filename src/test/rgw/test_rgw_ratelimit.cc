@@ -265,6 +265,34 @@ TEST(RGWRateLimit, unlimited_access_not_left_large_write_ops_budget)
   EXPECT_EQ(0, delay);
 }
 
+TEST(RGWRateLimit, concurrent_first_requests_share_one_entry)
+{
+  // racing requests for a key that is not in the map yet must all end up on
+  // the same entry, so exactly max_read_ops of them are accepted
+  std::atomic_bool replacing;
+  std::condition_variable cv;
+  RateLimiter ratelimit(g_ceph_context, replacing, cv);
+  RGWRateLimitInfo info;
+  info.enabled = true;
+  info.max_read_ops = 100;
+  auto time = ceph::coarse_real_clock::now();
+  std::atomic<int> accepted = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 50; i++) {
+        if (ratelimit.should_rate_limit("GET", "uuser_race", time, &info, "") == 0) {
+          accepted++;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(100, accepted);
+}
+
 TEST(RGWRateLimitGC, NO_GC_AHEAD_OF_TIME)
 {
   // Test if GC is not starting the replace before getting to map_size * 0.9
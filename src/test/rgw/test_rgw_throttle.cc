@@ -101,6 +101,27 @@ TEST(Aio_Throttle, CostOverWindow)
   EXPECT_EQ(-EDEADLK, c.front().result);
 }
 
+TEST(Aio_Throttle, SetWindow)
+{
+  BlockingAioThrottle throttle(4);
+  auto obj = make_obj(__PRETTY_FUNCTION__);
+
+  // a cost over the window is rejected until the window grows
+  scoped_completion op1;
+  auto c1 = throttle.get(obj, wait_on(op1), 8, 0);
+  ASSERT_EQ(1u, c1.size());
+  EXPECT_EQ(-EDEADLK, c1.front().result);
+
+  throttle.set_window(8);
+  scoped_completion op2;
+  auto c2 = throttle.get(obj, wait_on(op2), 8, 0);
+  EXPECT_TRUE(c2.empty());
+  op2.complete(0);
+  auto completions = throttle.drain();
+  ASSERT_EQ(1u, completions.size());
+  EXPECT_EQ(0, completions.front().result);
+}
+
 TEST(Aio_Throttle, ThrottleOverMax)
 {
   constexpr uint64_t window = 4;
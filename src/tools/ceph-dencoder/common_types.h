@@ -458,6 +458,9 @@ MESSAGE(MOSDMap)
 #include "messages/MOSDOp.h"
 MESSAGE(MOSDOp)
 
+#include "messages/MOSDOpBatch.h"
+MESSAGE(MOSDOpBatch)
+
 #include "messages/MOSDOpReply.h"
 MESSAGE(MOSDOpReply)
 
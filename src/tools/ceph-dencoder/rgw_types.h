@@ -100,6 +100,7 @@ TYPE(rgw_cls_bi_list_op)
 TYPE(rgw_cls_bi_list_ret)
 TYPE(rgw_cls_bi_put_op)
 TYPE(rgw_cls_bi_put_entries_op)
+TYPE(rgw_cls_reshard_log_trim_entries_op)
 TYPE(rgw_cls_obj_check_attrs_prefix)
 TYPE(rgw_cls_obj_remove_op)
 TYPE(rgw_cls_obj_store_pg_ver_op)